@@ -0,0 +1,98 @@
+// Headless benchmark of the full mixing path: drives the engine's device
+// callbacks from a synthetic clock (AudioEngine::InitOffline) and reports the
+// cost of one 10 ms period for 1..256 concurrent voices.
+//
+// Build with CMake from this directory (Linux or Windows), then run EngineBench.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "MixKernels.h"
+#include "RtCheck.h"
+
+const unsigned int SAMPLE_RATE = 48000;
+const unsigned int CHANNELS = 2;
+const unsigned int FRAMES_PER_BLOCK = 480; // 10 ms
+const int WARMUP_BLOCKS = 50;
+const int MEASURED_BLOCKS = 1000;
+
+static std::shared_ptr<AudioData> MakeTone(float seconds, float hz) {
+    auto data = std::make_shared<AudioData>();
+    size_t frames = (size_t)(seconds * SAMPLE_RATE);
+    data->samples.resize(frames * CHANNELS);
+    for (size_t i = 0; i < frames; ++i) {
+        float s = 0.25f * std::sin(2.0f * 3.14159265f * hz * (float)i / SAMPLE_RATE);
+        data->samples[i * CHANNELS] = s;
+        data->samples[i * CHANNELS + 1] = s;
+    }
+    data->byteSize = data->samples.size() * sizeof(float);
+    data->pcm = data->samples.data();
+    data->samplesReady = data->samples.size();
+    data->complete = true;
+    return data;
+}
+
+int main() {
+    AudioEngine engine;
+    if (!engine.InitOffline()) {
+        printf("InitOffline failed\n");
+        return 1;
+    }
+    engine.SetSoundVolume(0.5f);
+    engine.SetMicVolume(1.0f);
+    engine.SetVoiceLimit(MixBus::MAX_VOICES);
+
+    // Long enough that no voice ends during a measurement
+    float seconds = (float)(WARMUP_BLOCKS + MEASURED_BLOCKS + 10) * FRAMES_PER_BLOCK / SAMPLE_RATE;
+    auto tone = MakeTone(seconds, 440.0f);
+
+    std::vector<float> mic(FRAMES_PER_BLOCK * CHANNELS, 0.01f);
+    std::vector<float> cable(FRAMES_PER_BLOCK * CHANNELS);
+    std::vector<float> monitor(FRAMES_PER_BLOCK * CHANNELS);
+    std::vector<double> timings(MEASURED_BLOCKS);
+
+    const double blockBudgetNs = 1e9 * FRAMES_PER_BLOCK / SAMPLE_RATE;
+
+    printf("Offline render: %u frames/block @ %u Hz, %d blocks, mix kernel %s\n\n",
+        FRAMES_PER_BLOCK, SAMPLE_RATE, MEASURED_BLOCKS, MixKernels::GetActiveKernelName());
+    printf("%7s %12s %12s %12s %12s %9s\n", "voices", "mean ns/blk", "p99 ns/blk", "max ns/blk", "ns/voice", "budget");
+
+    for (int voices = 1; voices <= 256; voices *= 2) {
+        engine.StopAllSounds();
+        engine.RenderOffline(mic.data(), cable.data(), monitor.data(), FRAMES_PER_BLOCK);
+
+        for (int v = 0; v < voices; ++v) engine.PlayAudioData(tone);
+        for (int b = 0; b < WARMUP_BLOCKS; ++b) {
+            engine.RenderOffline(mic.data(), cable.data(), monitor.data(), FRAMES_PER_BLOCK);
+        }
+
+        for (int b = 0; b < MEASURED_BLOCKS; ++b) {
+            auto start = std::chrono::steady_clock::now();
+            engine.RenderOffline(mic.data(), cable.data(), monitor.data(), FRAMES_PER_BLOCK);
+            auto end = std::chrono::steady_clock::now();
+            timings[b] = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        double mean = 0.0;
+        for (double t : timings) mean += t;
+        mean /= MEASURED_BLOCKS;
+        std::sort(timings.begin(), timings.end());
+        double p99 = timings[(size_t)(MEASURED_BLOCKS * 0.99)];
+        double worst = timings.back();
+
+        printf("%7d %12.0f %12.0f %12.0f %12.1f %8.2f%%\n",
+            voices, mean, p99, worst, mean / voices, 100.0 * mean / blockBudgetNs);
+    }
+
+#ifdef VIBEPAD_RT_CHECK
+    printf("\nHeap allocations/frees on the audio path: %llu\n", (unsigned long long)RtCheck::GetViolationCount());
+#endif
+
+    engine.Shutdown();
+    return 0;
+}
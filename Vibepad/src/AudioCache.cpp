@@ -0,0 +1,110 @@
+#include "AudioCache.h"
+#include "AudioEngine.h"
+
+// Entries leaving the cache are moved here and released after the lock, so a large
+// buffer's free never stalls an Acquire from the UI or a decoder thread.
+// Declared before the lock_guard, it is destroyed after it.
+using Evicted = std::vector<std::shared_ptr<AudioData>>;
+
+void AudioCache::SetBudget(size_t bytes) {
+    Evicted evicted;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+    TrimLocked(evicted);
+}
+
+std::shared_ptr<AudioData> AudioCache::Acquire(const std::wstring& key, bool& inserted) {
+    Evicted evicted;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        m_hits++;
+        inserted = false;
+        return it->second->data;
+    }
+
+    m_misses++;
+    inserted = true;
+    auto data = std::make_shared<AudioData>();
+    m_lru.push_front({ key, data });
+    m_index[key] = m_lru.begin();
+    TrimLocked(evicted);
+    return data;
+}
+
+void AudioCache::Replace(const std::wstring& key, const std::shared_ptr<AudioData>& expected, std::shared_ptr<AudioData> replacement) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end() && it->second->data == expected) it->second->data = std::move(replacement);
+}
+
+void AudioCache::Remove(const std::wstring& key, const std::shared_ptr<AudioData>& expected) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end() && it->second->data == expected) {
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+}
+
+void AudioCache::Erase(const std::wstring& key) {
+    Evicted evicted;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        evicted.push_back(std::move(it->second->data));
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+}
+
+void AudioCache::Clear() {
+    std::list<Entry> entries;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    entries.swap(m_lru);
+    m_index.clear();
+}
+
+void AudioCache::Trim() {
+    Evicted evicted;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TrimLocked(evicted);
+}
+
+AudioCacheStats AudioCache::GetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    AudioCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entries = m_lru.size();
+    stats.bytesUsed = BytesUsedLocked();
+    stats.bytesBudget = m_budget;
+    return stats;
+}
+
+void AudioCache::TrimLocked(std::vector<std::shared_ptr<AudioData>>& evicted) {
+    size_t used = BytesUsedLocked();
+
+    for (auto it = m_lru.end(); used > m_budget && it != m_lru.begin(); ) {
+        --it;
+        // Pinned unless the cache holds the only reference (nothing playing or decoding it).
+        // Zero-byte entries (stream placeholders, pending decodes) would free nothing.
+        size_t bytes = it->data->byteSize.load(std::memory_order_acquire);
+        if (bytes == 0 || it->data.use_count() > 1) continue;
+
+        used -= bytes;
+        evicted.push_back(std::move(it->data));
+        m_index.erase(it->key);
+        it = m_lru.erase(it);
+        m_evictions++;
+    }
+}
+
+size_t AudioCache::BytesUsedLocked() const {
+    size_t used = 0;
+    for (const auto& entry : m_lru) used += entry.data->byteSize.load(std::memory_order_acquire);
+    return used;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+struct AudioData;
+
+struct AudioCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytesUsed = 0;
+    size_t bytesBudget = 0;
+};
+
+// Decoded-sound cache with least-recently-used eviction under a byte budget.
+// Entries still referenced elsewhere (playing voices, running decode jobs) are
+// pinned and never evicted, so eviction never frees memory the mixer can see.
+class AudioCache {
+public:
+    void SetBudget(size_t bytes);
+
+    // Returns the cached entry (hit) or inserts and returns a new empty one (miss)
+    std::shared_ptr<AudioData> Acquire(const std::wstring& key, bool& inserted);
+
+    // Swap/remove the entry only if it is still 'expected'
+    void Replace(const std::wstring& key, const std::shared_ptr<AudioData>& expected, std::shared_ptr<AudioData> replacement);
+    void Remove(const std::wstring& key, const std::shared_ptr<AudioData>& expected);
+    void Erase(const std::wstring& key);
+    // Drops every entry (the engine's output format changed); voices keep theirs until they finish
+    void Clear();
+
+    // Evicts unpinned entries, oldest first, until the cache fits its budget
+    void Trim();
+
+    AudioCacheStats GetStats();
+
+private:
+    struct Entry {
+        std::wstring key;
+        std::shared_ptr<AudioData> data;
+    };
+
+    // Moves evicted entries into 'evicted', for the caller to release once unlocked
+    void TrimLocked(std::vector<std::shared_ptr<AudioData>>& evicted);
+    size_t BytesUsedLocked() const;
+
+    std::list<Entry> m_lru; // Front = most recently used
+    std::unordered_map<std::wstring, std::list<Entry>::iterator> m_index;
+    std::mutex m_mutex;
+
+    size_t m_budget = 512ull * 1024 * 1024;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
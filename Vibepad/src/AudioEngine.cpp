@@ -1,17 +1,63 @@
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 #include <windows.h>
+#endif
 #include <iostream>
 #include <algorithm>
 #include <vector>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
 
 #include "AudioEngine.h"
+#include "MixKernels.h"
+#include "RtCheck.h"
 #include "Utils.h"
 
 #define MINIAUDIO_IMPLEMENTATION
 #include "../lib/miniaudio.h"
 
-const int SAMPLE_RATE = 48000;
-const int CHANNELS = 2;
+// Bus format until Init learns the cable device's
+const unsigned int DEFAULT_SAMPLE_RATE = 48000;
+const unsigned int DEFAULT_CHANNELS = 2;
+
+// Devices with more channels get stereo; miniaudio maps it onto their layout
+const unsigned int MAX_CHANNELS = 2;
+
+// First chunk is kept short so playback can start quickly, the rest is decoded in larger steps
+const ma_uint64 DECODE_FIRST_CHUNK_FRAMES = 4096;
+const ma_uint64 DECODE_CHUNK_FRAMES = 48000;
+
+// Start of a mapped sound faulted in before it is published
+const float MAPPED_WARM_SECONDS = 5.0f;
+
+// Prefetch window of a streamed voice (1 second)
+const size_t STREAM_BUFFER_FRAMES = 48000;
+
+// Mic ring capacity; the jitter buffer keeps only a small part of it filled
+const float MIC_RING_SECONDS = 0.25f;
+
+// Largest block the resamplers process in one pass (longer callbacks are split)
+const size_t RESAMPLER_BLOCK_FRAMES = 4096;
+
+// Mixed frames the cable can hand to the monitor ahead of its reads
+const float MONITOR_RING_SECONDS = 0.25f;
+
+// Buffering the monitor keeps on top of one cable and one monitor period, for callback jitter (3 ms)
+const float MONITOR_MARGIN_SECONDS = 0.003f;
+
+// Fade that conceals a mic underrun (2 ms)
+const size_t MIC_FADE_FRAMES = 96;
+
+// Glide of the mic and sound volumes after a change, and of the mic fade-in once its buffer refilled
+const float VOLUME_RAMP_MS = 20.0f;
+
+// Fade of a voice stolen for a new trigger; it finishes in a slot of its own
+const float STEAL_FADE_MS = 5.0f;
 
 // -----------------------------------------------------------------------------
 // HELPERS
@@ -24,6 +70,79 @@ ma_device_id* FindDeviceID(ma_device_info* infoList, ma_uint32 count, const std:
     return NULL;
 }
 
+// Shared-mode format of a device (pID null = default device). Leaves the outputs untouched
+// if the backend doesn't report one.
+static void QueryNativeFormat(ma_context* pContext, ma_device_type type, const ma_device_id* pID, unsigned int* pSampleRate, unsigned int* pChannels) {
+    ma_device_info info;
+    if (ma_context_get_device_info(pContext, type, pID, &info) != MA_SUCCESS) return;
+    for (ma_uint32 i = 0; i < info.nativeDataFormatCount; ++i) {
+        const auto& native = info.nativeDataFormats[i];
+        if (native.flags & MA_DATA_FORMAT_FLAG_EXCLUSIVE_MODE) continue;
+        if (native.sampleRate != 0) *pSampleRate = native.sampleRate;
+        if (native.channels != 0) *pChannels = native.channels;
+        return;
+    }
+}
+
+static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Maps a WAV file whose samples are already interleaved f32 or s16 at the engine rate
+// and channel count, so the mixer can read them in place. Anything else returns null.
+static std::unique_ptr<MappedFile> MapEngineFormatWav(const std::wstring& fullPath, unsigned int engineRate, unsigned int engineChannels,
+    const void** ppSamples, size_t* pSampleCount, SampleFormat* pFormat) {
+    auto file = std::make_unique<MappedFile>();
+    if (!file->Open(std::filesystem::path(fullPath))) return nullptr;
+
+    const uint8_t* p = (const uint8_t*)file->Data();
+    size_t size = file->Size();
+    if (size < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) return nullptr;
+
+    bool formatOk = false;
+    SampleFormat format = SampleFormat::F32;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, p + offset + 4, 4);
+        const uint8_t* chunk = p + offset + 8;
+        size_t available = size - offset - 8;
+
+        if (memcmp(p + offset, "fmt ", 4) == 0 && chunkSize >= 16 && available >= 16) {
+            uint16_t formatTag, channels, bitsPerSample;
+            uint32_t sampleRate;
+            memcpy(&formatTag, chunk, 2);
+            memcpy(&channels, chunk + 2, 2);
+            memcpy(&sampleRate, chunk + 4, 4);
+            memcpy(&bitsPerSample, chunk + 14, 2);
+
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format code at the start of its sub-format GUID
+            if (formatTag == 0xFFFE && chunkSize >= 40 && available >= 40) memcpy(&formatTag, chunk + 24, 2);
+
+            bool isF32 = formatTag == 3 /* IEEE float */ && bitsPerSample == 32;
+            bool isS16 = formatTag == 1 /* PCM */ && bitsPerSample == 16;
+            formatOk = (isF32 || isS16) && channels == engineChannels && sampleRate == engineRate;
+            if (!formatOk) return nullptr;
+            format = isS16 ? SampleFormat::S16 : SampleFormat::F32;
+        }
+        else if (memcmp(p + offset, "data", 4) == 0) {
+            size_t dataOffset = offset + 8;
+            size_t sampleSize = SampleFormatSize(format);
+            size_t count = std::min<size_t>(chunkSize, available) / sampleSize;
+            count -= count % engineChannels;
+            if (!formatOk || count == 0 || dataOffset % sampleSize != 0) return nullptr;
+
+            *ppSamples = p + dataOffset;
+            *pSampleCount = count;
+            *pFormat = format;
+            return file;
+        }
+
+        offset += 8 + (size_t)chunkSize + (chunkSize & 1); // Chunks are padded to even sizes
+    }
+    return nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // CALLBACK WRAPPERS
 // -----------------------------------------------------------------------------
@@ -45,19 +164,49 @@ void DataCallback_Monitor(ma_device* pDevice, void* pOutput, const void* pInput,
 // -----------------------------------------------------------------------------
 // AUDIO ENGINE IMPLEMENTATION
 // -----------------------------------------------------------------------------
-AudioEngine::AudioEngine() {
+AudioEngine::AudioEngine()
+    : m_micJitter(DEFAULT_SAMPLE_RATE), m_monitorDrift(DEFAULT_SAMPLE_RATE),
+    m_captureMeter(DEFAULT_SAMPLE_RATE), m_cableMeter(DEFAULT_SAMPLE_RATE), m_monitorMeter(DEFAULT_SAMPLE_RATE) {
     m_pContext = new ma_context();
     m_pCaptureDevice = new ma_device();
     m_pCableDevice = new ma_device();
     m_pMonitorDevice = new ma_device();
     m_pMicBuffer = new ma_rb();
+    m_pMonitorRing = new ma_rb();
+
+    m_mixBus.streamReader = 0;
+    m_monitorResampler.Init(DEFAULT_CHANNELS, RESAMPLER_BLOCK_FRAMES);
+    m_micResampler.Init(DEFAULT_CHANNELS, RESAMPLER_BLOCK_FRAMES, ResampleQuality::Cubic);
+    m_micBlock.resize(RESAMPLER_BLOCK_FRAMES * DEFAULT_CHANNELS);
+    m_micHold.resize(DEFAULT_CHANNELS);
+    m_cableOnlyMix.resize(RESAMPLER_BLOCK_FRAMES * MAX_CHANNELS);
+    m_mixBus.volume.Init(DEFAULT_SAMPLE_RATE, VOLUME_RAMP_MS, RampShape::Exponential);
+    m_micGain.Init(DEFAULT_SAMPLE_RATE, VOLUME_RAMP_MS, RampShape::Exponential);
+    m_monitorOnlyMix.resize(RESAMPLER_BLOCK_FRAMES * MAX_CHANNELS);
+    m_cableLimiter.Init(DEFAULT_CHANNELS, DEFAULT_SAMPLE_RATE);
+    m_monitorLimiter.Init(DEFAULT_CHANNELS, DEFAULT_SAMPLE_RATE);
+
+    // Resolve the SIMD dispatch here rather than inside the first audio callback
+    MixKernels::GetActiveKernelName();
 
     ma_context_init(NULL, 0, NULL, m_pContext);
     RefreshDeviceList();
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    m_decoderPool.Start(std::clamp(cores / 2, 1u, 4u));
+    m_analysisPool.Start(1);
+    m_prefetcher.Start();
+    m_reclaimer.Start();
 }
 
 AudioEngine::~AudioEngine() {
+    m_analysisPool.Stop();
+    m_preloadPool.Stop();
+    m_decoderPool.Stop();
     Shutdown();
+    m_reclaimer.Stop();
+    m_prefetcher.Stop();
+    delete (ma_rb*)m_pMonitorRing;
     delete (ma_rb*)m_pMicBuffer;
     delete m_pMonitorDevice;
     delete m_pCableDevice;
@@ -66,12 +215,35 @@ AudioEngine::~AudioEngine() {
     delete m_pContext;
 }
 
-bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& outputDeviceName, const std::string& monitorDeviceName) {
-    if (m_isInitialized) Shutdown();
+// Devices stopped. Sounds cached or playing in another format can't be mixed, so they are dropped.
+void AudioEngine::ApplyFormat(unsigned int sampleRate, unsigned int channels) {
+    if (sampleRate == m_sampleRate && channels == m_channels) return;
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+
+    m_monitorResampler.Init(channels, RESAMPLER_BLOCK_FRAMES);
+    m_micResampler.Init(channels, RESAMPLER_BLOCK_FRAMES, ResampleQuality::Cubic);
+    m_micBlock.assign(RESAMPLER_BLOCK_FRAMES * channels, 0.0f);
+    m_micHold.assign(channels, 0.0f);
+    m_cableLimiter.Init(channels, sampleRate);
+    m_monitorLimiter.Init(channels, sampleRate);
+    m_mixBus.volume.Init(sampleRate, VOLUME_RAMP_MS, RampShape::Exponential);
+    m_micGain.Init(sampleRate, VOLUME_RAMP_MS, RampShape::Exponential);
+    m_micJitter.SetSampleRate(sampleRate);
+    m_monitorDrift.SetNominalRate(sampleRate);
+    m_captureMeter.SetSampleRate(sampleRate);
+    m_cableMeter.SetSampleRate(sampleRate);
+    m_monitorMeter.SetSampleRate(sampleRate);
 
-    // 1. Buffer Setup (100ms for Low Latency)
-    size_t frameSizeInBytes = sizeof(float) * CHANNELS;
-    size_t bufferSizeInFrames = (size_t)(SAMPLE_RATE * 0.1f);
+    m_audioCache.Clear();
+    SoundCommand cmd;
+    cmd.type = SoundCommandType::StopAll;
+    PostCommand(cmd);
+}
+
+bool AudioEngine::InitMicBuffer() {
+    size_t frameSizeInBytes = sizeof(float) * m_channels;
+    size_t bufferSizeInFrames = (size_t)(m_sampleRate * MIC_RING_SECONDS);
     size_t bufferSizeInBytes = bufferSizeInFrames * frameSizeInBytes;
 
     // Store pointer to free it later
@@ -81,10 +253,64 @@ bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& ou
     ma_rb* rb = (ma_rb*)m_pMicBuffer;
     if (ma_rb_init(bufferSizeInBytes, m_pAudioBufferData, NULL, rb) != MA_SUCCESS) {
         ma_free(m_pAudioBufferData, NULL);
+        m_pAudioBufferData = nullptr;
+        return false;
+    }
+
+    m_micJitter.Reset();
+    m_micResampler.Reset();
+    m_micPlaying = false;
+    std::fill(m_micHold.begin(), m_micHold.end(), 0.0f);
+    return true;
+}
+
+bool AudioEngine::InitMonitorRing() {
+    size_t bufferSizeInBytes = (size_t)(m_sampleRate * MONITOR_RING_SECONDS) * m_channels * sizeof(float);
+    m_pMonitorRingData = ma_malloc(bufferSizeInBytes, NULL);
+
+    ma_rb* rb = (ma_rb*)m_pMonitorRing;
+    if (ma_rb_init(bufferSizeInBytes, m_pMonitorRingData, NULL, rb) != MA_SUCCESS) {
+        ma_free(m_pMonitorRingData, NULL);
+        m_pMonitorRingData = nullptr;
         return false;
     }
+    m_monitorPlaying = false;
+    m_monitorResync = false;
+    return true;
+}
 
-    // 2. Resolve Device IDs
+void AudioEngine::ResetClocks() {
+    m_cableFrames = 0;
+    m_cableBlockFrames = 0;
+    m_monitorResampler.Reset();
+    m_monitorDrift.Reset();
+    m_cableLimiter.Reset();
+    m_monitorLimiter.Reset();
+}
+
+bool AudioEngine::InitOffline(unsigned int sampleRate, unsigned int channels) {
+    if (m_isInitialized) Shutdown();
+    ApplyFormat(sampleRate, std::clamp(channels, 1u, MAX_CHANNELS));
+    if (!InitMicBuffer()) return false;
+    if (!InitMonitorRing()) return false;
+    ResetClocks();
+
+    m_isOffline = true;
+    m_isInitialized = true;
+    return true;
+}
+
+void AudioEngine::RenderOffline(const float* pMicInput, float* pCableOutput, float* pMonitorOutput, unsigned int frameCount) {
+    m_monitorMixes = pCableOutput == nullptr;
+    if (pMicInput) OnCapture(pMicInput, frameCount);
+    if (pCableOutput) OnCableProcess(pCableOutput, frameCount);
+    if (pMonitorOutput) OnMonitorProcess(pMonitorOutput, frameCount);
+}
+
+bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& outputDeviceName, const std::string& monitorDeviceName) {
+    if (m_isInitialized) Shutdown();
+
+    // 1. Resolve Device IDs
     ma_device_info* pPlaybackInfos;
     ma_uint32 playbackCount;
     ma_device_info* pCaptureInfos;
@@ -95,12 +321,23 @@ bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& ou
     ma_device_id* pCableID = FindDeviceID(pPlaybackInfos, playbackCount, outputDeviceName);
     ma_device_id* pMonitorID = FindDeviceID(pPlaybackInfos, playbackCount, monitorDeviceName);
 
-    // 3. Configure DEVICES (Low Latency)
+    // 2. Bus format: the cable's native one. The mic and monitor devices convert to it if they differ.
+    unsigned int sampleRate = DEFAULT_SAMPLE_RATE;
+    unsigned int channels = DEFAULT_CHANNELS;
+    QueryNativeFormat(m_pContext, ma_device_type_playback, pCableID, &sampleRate, &channels);
+    ApplyFormat(sampleRate, std::clamp(channels, 1u, MAX_CHANNELS));
+
+    // 3. Buffer Setup
+    if (!InitMicBuffer()) return false;
+    if (!InitMonitorRing()) return false;
+    ResetClocks();
+
+    // 4. Configure DEVICES (Low Latency)
     ma_device_config config = ma_device_config_init(ma_device_type_capture);
     config.capture.pDeviceID = pInputID;
     config.capture.format = ma_format_f32;
-    config.capture.channels = CHANNELS;
-    config.sampleRate = SAMPLE_RATE;
+    config.capture.channels = m_channels;
+    config.sampleRate = m_sampleRate;
     config.dataCallback = DataCallback_Capture;
     config.pUserData = this;
     config.performanceProfile = ma_performance_profile_low_latency;
@@ -113,8 +350,8 @@ bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& ou
     config = ma_device_config_init(ma_device_type_playback);
     config.playback.pDeviceID = pCableID;
     config.playback.format = ma_format_f32;
-    config.playback.channels = CHANNELS;
-    config.sampleRate = SAMPLE_RATE;
+    config.playback.channels = m_channels;
+    config.sampleRate = m_sampleRate;
     config.dataCallback = DataCallback_Cable;
     config.pUserData = this;
     config.performanceProfile = ma_performance_profile_low_latency;
@@ -127,9 +364,10 @@ bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& ou
 
     ma_device_init(m_pContext, &config, m_pMonitorDevice);
 
-    // 4. Start
+    // 5. Start. Without a running cable nothing feeds the monitor ring, so the monitor mixes.
     ma_device_start(m_pCaptureDevice);
     ma_device_start(m_pCableDevice);
+    m_monitorMixes = ma_device_get_state(m_pCableDevice) != ma_device_state_started;
     if (ma_device_get_state(m_pMonitorDevice) == ma_device_state_started ||
         ma_device_get_state(m_pMonitorDevice) == ma_device_state_stopped) {
         ma_device_start(m_pMonitorDevice);
@@ -141,16 +379,24 @@ bool AudioEngine::Init(const std::string& inputDeviceName, const std::string& ou
 
 void AudioEngine::Shutdown() {
     if (!m_isInitialized) return;
-    ma_device_uninit(m_pCaptureDevice);
-    ma_device_uninit(m_pCableDevice);
-    ma_device_uninit(m_pMonitorDevice);
+    if (!m_isOffline) {
+        ma_device_uninit(m_pCaptureDevice);
+        ma_device_uninit(m_pCableDevice);
+        ma_device_uninit(m_pMonitorDevice);
+    }
     ma_rb_uninit((ma_rb*)m_pMicBuffer);
+    ma_rb_uninit((ma_rb*)m_pMonitorRing);
+    if (m_pMonitorRingData) {
+        ma_free(m_pMonitorRingData, NULL);
+        m_pMonitorRingData = nullptr;
+    }
 
     if (m_pAudioBufferData) {
         ma_free(m_pAudioBufferData, NULL);
         m_pAudioBufferData = nullptr;
     }
 
+    m_isOffline = false;
     m_isInitialized = false;
 }
 
@@ -170,153 +416,842 @@ std::vector<DeviceInfo> AudioEngine::GetOutputDevices() { return m_outputDevices
 // -----------------------------------------------------------------------------
 // PLAYBACK LOGIC
 // -----------------------------------------------------------------------------
-void AudioEngine::PlaySoundFile(const std::wstring& fullPath) {
-    std::shared_ptr<AudioData> audioData = nullptr;
+void AudioEngine::SetDecodeCallback(DecodeCallback callback) {
+    m_decodeCallback = std::move(callback);
+}
+
+void AudioEngine::PlaySoundFile(const std::wstring& fullPath, const PlayParams& params) {
+    int64_t triggerNs = NowNs();
+    std::shared_ptr<AudioData> audioData;
+    bool needsDecode = false;
+    bool needsStream = false;
 
-    auto it = m_audioCache.find(fullPath);
-    if (it != m_audioCache.end()) {
-        audioData = it->second;
+    audioData = m_audioCache.Acquire(fullPath, needsDecode);
+    if (audioData->streamPlaceholder) {
+        audioData = std::make_shared<AudioData>(); // Per-voice, never cached
+        needsStream = true;
     }
-    else {
-        std::string pathUtf8 = Utils::WideToUtf8(fullPath);
-        ma_decoder decoder;
-        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, CHANNELS, SAMPLE_RATE);
 
-        if (ma_decoder_init_file(pathUtf8.c_str(), &config, &decoder) != MA_SUCCESS) {
-            return;
+    if (needsDecode || needsStream) {
+        m_decoderPool.Submit([this, fullPath, audioData, needsStream]() {
+            bool success = needsStream ? OpenStream(fullPath, audioData) : DecodeFile(fullPath, audioData);
+            if (m_decodeCallback) m_decodeCallback(fullPath, success);
+            });
+    }
+
+    // The voice waits on samplesReady, so it can be queued before any data exists
+    SoundCommand cmd;
+    cmd.type = SoundCommandType::Play;
+    cmd.data = std::move(audioData);
+    cmd.params = params;
+    cmd.triggerNs = triggerNs;
+    PostCommand(cmd);
+}
+
+void AudioEngine::PlayAudioData(std::shared_ptr<AudioData> audioData, const PlayParams& params) {
+    SoundCommand cmd;
+    cmd.type = SoundCommandType::Play;
+    cmd.data = std::move(audioData);
+    cmd.params = params;
+    PostCommand(cmd);
+}
+
+void AudioEngine::Preload(const std::vector<std::wstring>& fullPaths, unsigned int threadCount, PreloadCallback callback) {
+    if (threadCount == 0) {
+        // hardware_concurrency() may report 0 when unknown
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = std::clamp(cores > 1 ? cores - 1 : 1u, 1u, 4u);
+    }
+    m_preloadPool.Start(threadCount);
+    m_preloadDone = 0;
+    m_preloadFailed = 0;
+
+    size_t total = fullPaths.size();
+    auto startTime = std::chrono::steady_clock::now();
+    if (total == 0) {
+        if (callback) callback(PreloadProgress());
+        return;
+    }
+
+    for (const auto& fullPath : fullPaths) {
+        m_preloadPool.Submit([this, fullPath, total, startTime, callback]() {
+            bool inserted = false;
+            std::shared_ptr<AudioData> audioData = m_audioCache.Acquire(fullPath, inserted);
+            bool success = inserted ? DecodeFile(fullPath, audioData) : true;
+            audioData.reset();
+
+            if (!success) m_preloadFailed++;
+            PreloadProgress progress;
+            progress.done = ++m_preloadDone;
+            progress.total = total;
+            progress.failed = m_preloadFailed;
+            progress.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            if (callback) callback(progress);
+            });
+    }
+}
+
+bool AudioEngine::DecodeFile(const std::wstring& fullPath, const std::shared_ptr<AudioData>& audioData) {
+    // The engine format at the start of the job; the mixer drops the result if it changes meanwhile
+    const unsigned int sampleRate = m_sampleRate;
+    const unsigned int channels = m_channels;
+    audioData->sampleRate = sampleRate;
+    audioData->channels = channels;
+    ma_uint64 streamThreshold = (ma_uint64)(m_streamThresholdSeconds.load() * sampleRate);
+
+    // Mapped PCM is published whole with no decoder involved. An engine-format WAV is
+    // mapped at any length since it costs no heap; disk cache entries above the
+    // stream threshold (left over from a higher setting) are ignored.
+    SampleFormat format = m_compactCache ? SampleFormat::S16 : SampleFormat::F32;
+    const DecodeQuality quality = m_decodeQuality;
+    const void* pMapped = nullptr;
+    size_t mappedCount = 0;
+    SampleFormat mappedFormat = format;
+    std::unique_ptr<MappedFile> mapping = MapEngineFormatWav(fullPath, sampleRate, channels, &pMapped, &mappedCount, &mappedFormat);
+    if (!mapping) {
+        mapping = m_diskCache.Load(fullPath, channels, sampleRate, format, quality, &pMapped, &mappedCount);
+        if (mapping && mappedCount / channels > streamThreshold) mapping.reset();
+    }
+    if (mapping) {
+        // The mixer must not take the hard page faults of a cold file: read the start in
+        // here and let the OS read ahead of playback for the rest
+        size_t warmSamples = std::min(mappedCount, (size_t)(MAPPED_WARM_SECONDS * sampleRate) * channels);
+        mapping->Warm(pMapped, warmSamples * SampleFormatSize(mappedFormat));
+        audioData->mapping = std::move(mapping);
+        audioData->pcm = pMapped;
+        audioData->format = mappedFormat;
+        audioData->readyNs.store(NowNs(), std::memory_order_relaxed);
+        audioData->samplesReady.store(mappedCount, std::memory_order_release);
+        audioData->complete.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Linear lets the decoder convert on the fly. The sinc qualities decode at the source
+    // rate as f32 and convert each decoded span once; if the source is already at the engine
+    // rate the decoder is reopened in the storage format and nothing is converted.
+    std::string pathUtf8 = Utils::WideToUtf8(fullPath);
+    const ma_format storageFormat = format == SampleFormat::S16 ? ma_format_s16 : ma_format_f32;
+    const bool highQuality = quality != DecodeQuality::Linear;
+    ma_decoder decoder;
+    ma_decoder_config config = ma_decoder_config_init(highQuality ? ma_format_f32 : storageFormat, channels, highQuality ? 0 : sampleRate);
+    ma_result result = ma_decoder_init_file(pathUtf8.c_str(), &config, &decoder);
+
+    bool convert = false;
+    if (result == MA_SUCCESS && highQuality) {
+        convert = decoder.outputSampleRate != sampleRate;
+        if (!convert && storageFormat != ma_format_f32) {
+            ma_decoder_uninit(&decoder);
+            config = ma_decoder_config_init(storageFormat, channels, sampleRate);
+            result = ma_decoder_init_file(pathUtf8.c_str(), &config, &decoder);
         }
+    }
 
-        ma_uint64 totalFrames = 0;
-        ma_decoder_get_length_in_pcm_frames(&decoder, &totalFrames);
-        if (totalFrames == 0) totalFrames = 1024 * 1024;
+    bool success = false;
+    if (result == MA_SUCCESS) {
+        SincResampler resampler;
+        if (convert) resampler.Init(decoder.outputSampleRate, sampleRate, channels, quality);
 
-        std::vector<float> tempBuffer(totalFrames * CHANNELS);
-        ma_uint64 framesRead = 0;
-        ma_decoder_read_pcm_frames(&decoder, tempBuffer.data(), totalFrames, &framesRead);
-        tempBuffer.resize(framesRead * CHANNELS);
-        ma_decoder_uninit(&decoder);
+        ma_uint64 sourceFrames = 0;
+        ma_decoder_get_length_in_pcm_frames(&decoder, &sourceFrames);
+        ma_uint64 totalFrames = convert ? resampler.OutputFrames((size_t)sourceFrames) : sourceFrames;
+
+        if (totalFrames > streamThreshold) {
+            ma_decoder_uninit(&decoder);
+
+            // Later plays see the placeholder and open their own stream
+            auto placeholder = std::make_shared<AudioData>();
+            placeholder->streamPlaceholder = true;
+            placeholder->complete = true;
+            m_audioCache.Replace(fullPath, audioData, placeholder);
+
+            // If a voice already holds audioData (the caller keeps one reference), turn it into a stream voice
+            if (audioData.use_count() > 1) return OpenStream(fullPath, audioData);
 
-        if (framesRead == 0) return;
+            audioData->complete.store(true, std::memory_order_release);
+            return true;
+        }
+
+        if (sourceFrames == 0) {
+            sourceFrames = 1024 * 1024;
+            totalFrames = convert ? resampler.OutputFrames((size_t)sourceFrames) : sourceFrames;
+        }
+
+        // Sized once before the first publish; the mixer reads it concurrently from here on
+        uint8_t* pBuffer;
+        size_t bufferBytes;
+        if (format == SampleFormat::S16) {
+            audioData->samples16.resize(totalFrames * channels);
+            pBuffer = (uint8_t*)audioData->samples16.data();
+            bufferBytes = audioData->samples16.capacity() * sizeof(int16_t);
+        }
+        else {
+            audioData->samples.resize(totalFrames * channels);
+            pBuffer = (uint8_t*)audioData->samples.data();
+            bufferBytes = audioData->samples.capacity() * sizeof(float);
+        }
+        audioData->pcm = pBuffer;
+        audioData->format = format;
+        audioData->byteSize.store(bufferBytes, std::memory_order_release);
+        const size_t frameBytes = channels * SampleFormatSize(format);
 
-        audioData = std::make_shared<AudioData>();
-        audioData->samples = std::move(tempBuffer);
+        // Source-rate audio awaiting conversion; freed when the decode ends
+        std::vector<float> source;
+        if (convert) source.resize(sourceFrames * channels);
 
-        m_audioCache[fullPath] = audioData;
+        ma_uint64 sourceDone = 0;
+        ma_uint64 framesDone = 0;
+        ma_uint64 chunk = DECODE_FIRST_CHUNK_FRAMES;
+        while (sourceDone < sourceFrames) {
+            ma_uint64 toRead = std::min(chunk, sourceFrames - sourceDone);
+            void* pDst = convert ? (void*)(source.data() + sourceDone * channels) : (void*)(pBuffer + sourceDone * frameBytes);
+            ma_uint64 framesRead = 0;
+            ma_decoder_read_pcm_frames(&decoder, pDst, toRead, &framesRead);
+            sourceDone += framesRead;
+            bool end = framesRead == 0 || sourceDone == sourceFrames;
+
+            // Converted frames are final once every tap they read has been decoded
+            ma_uint64 ready = sourceDone;
+            if (convert) {
+                size_t available = end ? resampler.OutputFrames((size_t)sourceDone) : resampler.OutputFramesReady((size_t)sourceDone);
+                ready = std::min<ma_uint64>(available, totalFrames);
+                resampler.Process(source.data(), (size_t)sourceDone, pBuffer, format, (size_t)framesDone, (size_t)ready);
+            }
+
+            if (ready > framesDone) {
+                if (framesDone == 0) audioData->readyNs.store(NowNs(), std::memory_order_relaxed);
+                framesDone = ready;
+                audioData->samplesReady.store((size_t)framesDone * channels, std::memory_order_release);
+            }
+            if (end) break;
+            chunk = DECODE_CHUNK_FRAMES;
+        }
+        ma_decoder_uninit(&decoder);
+        success = framesDone > 0;
     }
 
-    if (audioData) {
-        std::lock_guard<std::mutex> lock(m_soundMutex);
+    audioData->complete.store(true, std::memory_order_release);
 
-        ActiveSound sound;
-        sound.data = audioData; 
-        sound.cursorCable = 0;
-        sound.cursorMonitor = 0;
-        sound.finished = false;
+    if (success) {
+        m_diskCache.Store(fullPath, channels, sampleRate, format, quality, audioData->pcm, audioData->samplesReady.load(std::memory_order_relaxed));
+        m_audioCache.Trim();
+    }
+    else {
+        // Drop the failed entry so the next trigger retries instead of replaying silence
+        m_audioCache.Remove(fullPath, audioData);
+    }
+    return success;
+}
 
-        m_activeSounds.push_back(sound);
+bool AudioEngine::OpenStream(const std::wstring& fullPath, const std::shared_ptr<AudioData>& audioData) {
+    const unsigned int sampleRate = m_sampleRate;
+    const unsigned int channels = m_channels;
+    auto stream = std::make_shared<AudioStream>(channels, sampleRate, STREAM_BUFFER_FRAMES);
+    bool success = stream->Open(Utils::WideToUtf8(fullPath));
+
+    if (success) {
+        audioData->sampleRate = sampleRate;
+        audioData->channels = channels;
+        audioData->stream = stream;
+        audioData->readyNs.store(NowNs(), std::memory_order_relaxed);
+        audioData->isStream.store(true, std::memory_order_release);
+        m_prefetcher.Add(stream);
+    }
+    else {
+        audioData->complete.store(true, std::memory_order_release);
     }
+    return success;
 }
 
 void AudioEngine::FreeSound(const std::wstring& fullPath) {
-    m_audioCache.erase(fullPath);
+    m_audioCache.Erase(fullPath);
+    m_diskCache.Remove(fullPath);
 }
 
-void AudioEngine::StopAllSounds() {
-    std::lock_guard<std::mutex> lock(m_soundMutex);
-    m_activeSounds.clear();
+void AudioEngine::StopAllSounds(bool panic) {
+    SoundCommand cmd;
+    cmd.type = SoundCommandType::StopAll;
+    cmd.panic = panic;
+    PostCommand(cmd);
+}
+
+void AudioEngine::AnalyzeLoudness(const std::wstring& fullPath, LoudnessCallback callback) {
+    m_analysisPool.Submit([this, fullPath, callback]() {
+        // Measured in the engine's channel layout, as the sound is heard, at the file's own rate
+        const unsigned int channels = m_channels;
+        ma_decoder decoder;
+        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, channels, 0);
+        if (ma_decoder_init_file(Utils::WideToUtf8(fullPath).c_str(), &config, &decoder) != MA_SUCCESS) {
+            if (callback) callback(fullPath, false, LoudnessMeter::SILENCE_LUFS);
+            return;
+        }
+
+        LoudnessMeter meter(channels, decoder.outputSampleRate);
+        std::vector<float> chunk((size_t)DECODE_CHUNK_FRAMES * channels);
+        for (;;) {
+            ma_uint64 framesRead = 0;
+            ma_result result = ma_decoder_read_pcm_frames(&decoder, chunk.data(), DECODE_CHUNK_FRAMES, &framesRead);
+            meter.AddFrames(chunk.data(), (size_t)framesRead);
+            if (result != MA_SUCCESS || framesRead < DECODE_CHUNK_FRAMES) break;
+        }
+        ma_decoder_uninit(&decoder);
+
+        if (callback) callback(fullPath, true, meter.GetIntegratedLufs());
+        });
 }
 void AudioEngine::SetMicVolume(float volume) { m_micVolume = volume; }
-void AudioEngine::SetSoundVolume(float volume) { m_soundVolume = volume; }
+void AudioEngine::SetStreamThreshold(float seconds) { m_streamThresholdSeconds = seconds; }
+void AudioEngine::SetCacheBudget(size_t bytes) { m_audioCache.SetBudget(bytes); }
+AudioCacheStats AudioEngine::GetCacheStats() { return m_audioCache.GetStats(); }
+void AudioEngine::SetDiskCacheEnabled(bool enabled) { m_diskCache.SetEnabled(enabled); }
+void AudioEngine::SetCompactCache(bool compact) { m_compactCache = compact; }
+void AudioEngine::SetDecodeQuality(DecodeQuality quality) { m_decodeQuality = quality; }
+void AudioEngine::SetVoiceLimit(size_t voices) { m_voiceLimit = std::clamp<size_t>(voices, 1, MixBus::MAX_VOICES); }
+void AudioEngine::SetVoiceStealPolicy(VoiceStealPolicy policy) { m_voiceStealPolicy = policy; }
+void AudioEngine::SetStopFade(float ms) { m_stopFadeMs = std::clamp(ms, 1.0f, 500.0f); }
+void AudioEngine::SetLimiter(float ceilingDb, float releaseMs) {
+    m_cableLimiter.SetCeiling(ceilingDb);
+    m_cableLimiter.SetRelease(releaseMs);
+    m_monitorLimiter.SetCeiling(ceilingDb);
+    m_monitorLimiter.SetRelease(releaseMs);
+}
+ClockStats AudioEngine::GetClockStats() { return m_monitorDrift.GetStats(); }
+JitterStats AudioEngine::GetMicJitterStats() { return m_micJitter.GetStats(); }
+EngineStats AudioEngine::GetEngineStats(bool resetWindow) {
+    EngineStats stats;
+    stats.capture = m_captureMeter.GetStats(resetWindow);
+    stats.cable = m_cableMeter.GetStats(resetWindow);
+    stats.monitor = m_monitorMeter.GetStats(resetWindow);
+    stats.mic = m_micJitter.GetStats();
+    stats.cableLimiter = m_cableLimiter.GetStats(resetWindow);
+    stats.monitorLimiter = m_monitorLimiter.GetStats(resetWindow);
+    stats.droppedCommands = m_droppedCommands.load(std::memory_order_relaxed);
+    stats.monitorUnderruns = m_monitorUnderruns.load(std::memory_order_relaxed);
+    stats.reclaimOverflows = m_reclaimer.GetOverflowCount();
+    return stats;
+}
+
+LatencyReport AudioEngine::GetLatencyReport() { return m_latency.GetReport(); }
+void AudioEngine::ResetLatencyStats() { m_latency.Reset(); }
+bool AudioEngine::StartLatencyLog(const std::wstring& path) { return m_latency.StartLog(std::filesystem::path(path)); }
+void AudioEngine::StopLatencyLog() { m_latency.StopLog(); }
+
+void AudioEngine::SetSoundVolume(float volume) {
+    SoundCommand cmd;
+    cmd.type = SoundCommandType::SetVolume;
+    cmd.volume = volume;
+    PostCommand(cmd);
+}
+
+// Applied by the mixing callback at the start of its next block
+void AudioEngine::PostCommand(const SoundCommand& cmd) {
+    if (!m_mixBus.commands.Push(cmd)) m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+}
 
 // -----------------------------------------------------------------------------
 // REAL-TIME AUDIO PROCESSING
 // -----------------------------------------------------------------------------
 
 void AudioEngine::OnCapture(const void* pInput, unsigned int frameCount) {
+    RtCheck::Scope rtScope;
+    CallbackMeter::Scope meterScope(m_captureMeter, frameCount);
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
     ma_rb* rb = (ma_rb*)m_pMicBuffer;
-    size_t sizeInBytes = frameCount * CHANNELS * sizeof(float);
+    size_t bytesLeft = frameCount * channels * sizeof(float);
+    const char* pSrc = (const char*)pInput;
+
+    // Latency is managed on the read side; here the ring only overflows if the cable stalls
+    while (bytesLeft > 0) {
+        void* pWriteBuf = nullptr;
+        size_t sizeAvailable = bytesLeft;
+        if (ma_rb_acquire_write(rb, &sizeAvailable, &pWriteBuf) != MA_SUCCESS || sizeAvailable == 0) {
+            m_micJitter.OnOverrun();
+            break;
+        }
+        memcpy(pWriteBuf, pSrc, sizeAvailable);
+        ma_rb_commit_write(rb, sizeAvailable);
+        pSrc += sizeAvailable;
+        bytesLeft -= sizeAvailable;
+    }
+    m_micJitter.OnWrite(frameCount - (unsigned int)(bytesLeft / (channels * sizeof(float))), NowNs());
+}
 
-    // Anti-Lag: Drop old data if buffer gets clogged
-    size_t bytesInRB = ma_rb_available_read(rb);
-    size_t latencyThreshold = (size_t)(SAMPLE_RATE * 0.05f) * CHANNELS * sizeof(float);
+// Cable audio thread: copies up to frameCount mic frames into the zeroed pDst
+void AudioEngine::ReadMic(float* pDst, unsigned int frameCount) {
+    ma_rb* rb = (ma_rb*)m_pMicBuffer;
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
+    size_t bytesLeft = frameCount * channels * sizeof(float);
+    char* pOut = (char*)pDst;
 
-    if (bytesInRB > latencyThreshold) {
-        size_t bytesToSkip = bytesInRB - latencyThreshold;
-        ma_rb_seek_read(rb, bytesToSkip);
+    // Two passes at most: the ring hands out contiguous spans up to its wrap point
+    while (bytesLeft > 0) {
+        void* pReadBuf = nullptr;
+        size_t sizeAvailable = bytesLeft;
+        if (ma_rb_acquire_read(rb, &sizeAvailable, &pReadBuf) != MA_SUCCESS || sizeAvailable == 0) {
+            m_micJitter.OnUnderrun();
+            break;
+        }
+        memcpy(pOut, pReadBuf, sizeAvailable);
+        ma_rb_commit_read(rb, sizeAvailable);
+        pOut += sizeAvailable;
+        bytesLeft -= sizeAvailable;
     }
 
-    void* pWriteBuf = nullptr;
-    size_t sizeAvailable = sizeInBytes;
+    size_t got = frameCount - bytesLeft / (channels * sizeof(float));
+    m_micJitter.OnRead(got);
+    if (got > 0) memcpy(m_micHold.data(), pDst + (got - 1) * channels, channels * sizeof(float));
+    if (got == frameCount) return;
 
-    if (ma_rb_acquire_write(rb, &sizeAvailable, &pWriteBuf) == MA_SUCCESS) {
-        size_t bytesToCopy = (sizeInBytes < sizeAvailable) ? sizeInBytes : sizeAvailable;
-        memcpy(pWriteBuf, pInput, bytesToCopy);
-        ma_rb_commit_write(rb, bytesToCopy);
+    // Underrun: fade out from the last real frame instead of stepping to silence
+    size_t fade = std::min<size_t>(frameCount - got, MIC_FADE_FRAMES);
+    float* pGap = pDst + got * channels;
+    for (size_t i = 0; i < fade; ++i) {
+        float gain = 1.0f - (float)(i + 1) / (float)fade;
+        for (unsigned int c = 0; c < channels; ++c) pGap[i * channels + c] = m_micHold[c] * gain;
     }
+    std::fill(m_micHold.begin(), m_micHold.end(), 0.0f);
 }
 
 void AudioEngine::OnCableProcess(void* pOutput, unsigned int frameCount) {
+    RtCheck::Scope rtScope;
+    CallbackMeter::Scope meterScope(m_cableMeter, frameCount);
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
     float* pOutF32 = (float*)pOutput;
-    ma_rb* rb = (ma_rb*)m_pMicBuffer;
 
-    // 1. Music (Using Cable Cursor)
-    memset(pOutF32, 0, frameCount * CHANNELS * sizeof(float));
-    MixSounds(pOutF32, frameCount, false);
+    // 0. Master clock for the monitor's drift controller (no wall clock offline)
+    if (!m_isOffline) m_monitorDrift.PublishMaster(m_cableFrames, NowNs());
+    m_cableFrames += frameCount;
+    m_cableBlockFrames.store(frameCount, std::memory_order_relaxed);
 
-    // 2. Mic (Immediate Read)
-    size_t bytesNeeded = frameCount * CHANNELS * sizeof(float);
-    size_t bytesAvailable = ma_rb_available_read(rb);
+    // 1. Music, mixed once for both outputs. Every block goes to the monitor ring, silent
+    // or not, so ring frames stay on the cable timeline. Voices routed to one output are
+    // mixed apart and added only to that output's copy.
+    memset(pOutF32, 0, frameCount * channels * sizeof(float));
+    if (m_monitorMixes.load(std::memory_order_relaxed)) {
+        WriteMonitorRing(pOutF32, frameCount);
+    } else {
+        const unsigned int cableOnly = 1u << SoundRouteIndex(SoundRoute::Cable);
+        const unsigned int monitorOnly = 1u << SoundRouteIndex(SoundRoute::Monitor);
+        for (unsigned int done = 0; done < frameCount; ) {
+            unsigned int n = (unsigned int)std::min<size_t>(frameCount - done, RESAMPLER_BLOCK_FRAMES);
+            const size_t samples = (size_t)n * channels;
+            float* pShared = pOutF32 + (size_t)done * channels;
+            memset(m_cableOnlyMix.data(), 0, samples * sizeof(float));
+            memset(m_monitorOnlyMix.data(), 0, samples * sizeof(float));
+            float* const pTargets[3] = { m_cableOnlyMix.data(), m_monitorOnlyMix.data(), pShared };
 
-    if (bytesAvailable > 0) {
-        size_t bytesToRead = (bytesAvailable < bytesNeeded) ? bytesAvailable : bytesNeeded;
-        void* pBufferOut;
-
-        if (ma_rb_acquire_read(rb, &bytesToRead, &pBufferOut) == MA_SUCCESS) {
-            float* pMicData = (float*)pBufferOut;
-            float micVol = m_micVolume;
+            unsigned int mixed = MixSounds(m_mixBus, pTargets, n);
+            if (mixed & monitorOnly) {
+                MixKernels::MixAdd(m_monitorOnlyMix.data(), pShared, samples, 1.0f);
+                WriteMonitorRing(m_monitorOnlyMix.data(), n);
+            } else {
+                WriteMonitorRing(pShared, n);
+            }
+            if (mixed & cableOnly) MixKernels::MixAdd(pShared, m_cableOnlyMix.data(), samples, 1.0f);
+            done += n;
+        }
+    }
 
-            size_t floatsToRead = bytesToRead / sizeof(float);
-            for (size_t i = 0; i < floatsToRead; ++i) {
-                pOutF32[i] += pMicData[i] * micVol;
+    // 2. Mic, through the jitter buffer and drift resampler (silent while the buffer fills up
+    // to its start level, then ramped up from zero)
+    int64_t nowNs = NowNs();
+    if (m_micJitter.Update(frameCount, nowNs)) {
+        m_latency.RecordMicBuffer(m_micJitter.GetFill() / m_sampleRate.load(std::memory_order_relaxed), nowNs);
+        if (!m_micPlaying) m_micGain.Reset(0.0f);
+        m_micPlaying = true;
+        m_micGain.SetTarget(m_micVolume.load(std::memory_order_relaxed));
+        for (unsigned int done = 0; done < frameCount; ) {
+            unsigned int n = (unsigned int)std::min<size_t>(frameCount - done, RESAMPLER_BLOCK_FRAMES);
+            m_micResampler.Process(m_micBlock.data(), n, m_micJitter.GetRatio(), [this](float* pDst, unsigned int frames) {
+                ReadMic(pDst, frames);
+                });
+            float gainStart = m_micGain.GetValue();
+            float gainEnd = m_micGain.Advance(n);
+            float* pDst = pOutF32 + (size_t)done * channels;
+            if (gainStart == gainEnd) {
+                MixKernels::MixAdd(pDst, m_micBlock.data(), (size_t)n * channels, gainEnd);
+            } else {
+                const float start[MAX_CHANNELS] = { gainStart, gainStart };
+                const float step[MAX_CHANNELS] = { (gainEnd - gainStart) / n, (gainEnd - gainStart) / n };
+                MixKernels::MixAddRamp(pDst, m_micBlock.data(), (size_t)n * channels, channels, start, step);
             }
-            ma_rb_commit_read(rb, bytesToRead);
+            done += n;
+        }
+    } else {
+        m_micPlaying = false;
+    }
+
+    // 3. Sounds and mic together stay under the ceiling
+    m_cableLimiter.Process(pOutF32, frameCount);
+}
+
+// Cable audio thread. A full ring means the monitor stalled or isn't running; what doesn't fit is dropped.
+void AudioEngine::WriteMonitorRing(const float* pSrc, unsigned int frameCount) {
+    ma_rb* rb = (ma_rb*)m_pMonitorRing;
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
+    size_t bytesLeft = frameCount * channels * sizeof(float);
+    const char* pIn = (const char*)pSrc;
+
+    while (bytesLeft > 0) {
+        void* pWriteBuf = nullptr;
+        size_t sizeAvailable = bytesLeft;
+        if (ma_rb_acquire_write(rb, &sizeAvailable, &pWriteBuf) != MA_SUCCESS || sizeAvailable == 0) {
+            // The monitor's timeline no longer matches the cable's
+            m_monitorResync.store(true, std::memory_order_relaxed);
+            break;
         }
+        memcpy(pWriteBuf, pIn, sizeAvailable);
+        ma_rb_commit_write(rb, sizeAvailable);
+        pIn += sizeAvailable;
+        bytesLeft -= sizeAvailable;
+    }
+}
+
+// Monitor audio thread: copies up to frameCount mixed frames into the zeroed pDst
+void AudioEngine::ReadMonitorRing(float* pDst, unsigned int frameCount) {
+    ma_rb* rb = (ma_rb*)m_pMonitorRing;
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
+    size_t bytesLeft = frameCount * channels * sizeof(float);
+    char* pOut = (char*)pDst;
+
+    while (bytesLeft > 0) {
+        void* pReadBuf = nullptr;
+        size_t sizeAvailable = bytesLeft;
+        if (ma_rb_acquire_read(rb, &sizeAvailable, &pReadBuf) != MA_SUCCESS || sizeAvailable == 0) {
+            // Ran dry: the rest stays silent and the next block buffers up again
+            m_monitorUnderruns.fetch_add(1, std::memory_order_relaxed);
+            m_monitorPlaying = false;
+            break;
+        }
+        memcpy(pOut, pReadBuf, sizeAvailable);
+        ma_rb_commit_read(rb, sizeAvailable);
+        pOut += sizeAvailable;
+        bytesLeft -= sizeAvailable;
     }
 }
 
 void AudioEngine::OnMonitorProcess(void* pOutput, unsigned int frameCount) {
-    // Music (Using Monitor Cursor)
-    memset(pOutput, 0, frameCount * CHANNELS * sizeof(float));
-    MixSounds((float*)pOutput, frameCount, true);
+    RtCheck::Scope rtScope;
+    CallbackMeter::Scope meterScope(m_monitorMeter, frameCount);
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
+    float* pOutF32 = (float*)pOutput;
+
+    if (m_monitorMixes.load(std::memory_order_relaxed)) {
+        // Cable-only voices keep their place but aren't rendered
+        memset(pOutF32, 0, frameCount * channels * sizeof(float));
+        float* const pTargets[3] = { nullptr, pOutF32, pOutF32 };
+        MixSounds(m_mixBus, pTargets, frameCount);
+        m_monitorLimiter.Process(pOutF32, frameCount);
+        return;
+    }
+
+    // (Re)start: wait for a cable period, this period and a margin of mix, and skip anything
+    // older so the monitor stays as close behind the cable as its periods allow. Offline the
+    // cable renders just before, so one period is enough and the outputs line up exactly.
+    ma_rb* rb = (ma_rb*)m_pMonitorRing;
+    const size_t frameBytes = channels * sizeof(float);
+    if (m_monitorResync.exchange(false, std::memory_order_relaxed)) m_monitorPlaying = false;
+    if (!m_monitorPlaying) {
+        size_t target = frameCount;
+        if (!m_isOffline) {
+            target += m_cableBlockFrames.load(std::memory_order_relaxed) +
+                (size_t)(m_sampleRate.load(std::memory_order_relaxed) * MONITOR_MARGIN_SECONDS);
+        }
+        size_t fill = ma_rb_available_read(rb) / frameBytes;
+        if (fill < target) {
+            memset(pOutF32, 0, frameCount * frameBytes);
+            m_monitorLimiter.Process(pOutF32, frameCount); // Flushes its delay line
+            return;
+        }
+        ma_rb_seek_read(rb, (fill - target) * frameBytes);
+        m_monitorResampler.Reset();
+        m_monitorDrift.Relock();
+        m_monitorPlaying = true;
+    }
+
+    // Resampled so it stays sample-locked to the cable timeline (exactly 1:1 offline)
+    double ratio = 1.0;
+    if (!m_isOffline) ratio = m_monitorDrift.Update(m_monitorResampler.GetPosition(), NowNs(), frameCount);
+
+    m_monitorResampler.Process(pOutF32, frameCount, ratio, [this](float* pDst, unsigned int frames) {
+        ReadMonitorRing(pDst, frames);
+        });
+    m_monitorLimiter.Process(pOutF32, frameCount);
+}
+
+// Contiguous samples the voice can read right now (0 while its data is still loading).
+// 'isStream' is read once per block, so a voice never reads a stream it hasn't claimed.
+static size_t PeekVoice(ActiveSound& sound, bool isStream, int reader, const void** ppData) {
+    AudioData& data = *sound.data;
+    if (isStream) {
+        const float* pStream = nullptr;
+        size_t available = data.stream->Peek(reader, sound.cursor, &pStream);
+        *ppData = pStream;
+        return available;
+    }
+    size_t ready = data.samplesReady.load(std::memory_order_acquire);
+    if (sound.cursor >= ready) return 0;
+    *ppData = (const uint8_t*)data.pcm + sound.cursor * SampleFormatSize(data.format);
+    return ready - sound.cursor;
+}
+
+static bool IsVoiceFinished(const ActiveSound& sound, int reader) {
+    AudioData& data = *sound.data;
+    if (data.isStream.load(std::memory_order_acquire)) {
+        return data.stream->IsFinished(reader, sound.cursor);
+    }
+    // Read 'complete' first: once set, samplesReady is final
+    bool complete = data.complete.load(std::memory_order_acquire);
+    return complete && sound.cursor >= data.samplesReady.load(std::memory_order_acquire);
+}
+
+// A stream has a single read position per bus. Voices come to share one when a sound is
+// triggered again before its decode job found it long enough to stream; the first voice
+// mixed keeps the stream and the others end rather than move its position under it.
+static bool ClaimStream(ActiveSound& sound) {
+    AudioData& data = *sound.data;
+    if (data.streamVoice == 0) data.streamVoice = sound.serial + 1;
+    return data.streamVoice == sound.serial + 1;
+}
+
+static void ReleaseVoice(ActiveSound& sound, int reader) {
+    if (sound.data->isStream.load(std::memory_order_acquire) && sound.data->streamVoice == sound.serial + 1) {
+        sound.data->stream->ReleaseReader(reader);
+    }
+}
+
+// Cheap loudness estimate for voice stealing: |sample| summed over every 16th sample of a span
+static void AccumulateLevel(const void* pData, SampleFormat format, size_t count, float& sum, size_t& taps) {
+    const size_t STRIDE = 16;
+    if (format == SampleFormat::S16) {
+        const int16_t* p = (const int16_t*)pData;
+        for (size_t i = 0; i < count; i += STRIDE, ++taps) sum += std::abs((float)p[i]) * (1.0f / 32768.0f);
+    }
+    else {
+        const float* p = (const float*)pData;
+        for (size_t i = 0; i < count; i += STRIDE, ++taps) sum += std::abs(p[i]);
+    }
+}
+
+// Nothing below may drop the last reference to an AudioData: every reference
+// leaving a bus goes through m_reclaimer (one lane per bus, indexed like the stream readers)
+
+// Takes a free slot while the bus is under the voice limit, otherwise fades out the
+// voice the policy picks and starts the new one beside it. Voices already fading out
+// don't count toward the limit. Lowering the limit only takes effect as voices end.
+int AudioEngine::AllocateVoice(MixBus& bus, uint64_t incomingTag) {
+    const size_t limit = m_voiceLimit.load(std::memory_order_relaxed);
+    if (bus.voices.Size() < limit) {
+        int slot = bus.voices.Allocate();
+        if (slot >= 0) return slot;
+    }
+
+    VoiceStealPolicy policy = m_voiceStealPolicy.load(std::memory_order_relaxed);
+    size_t sounding = 0;
+    int victim = -1;   // Sounding voice the policy picks
+    int faintest = -1; // Fading voice closest to silence
+    for (size_t i = 0; i < bus.voices.Size(); ++i) {
+        int slot = bus.voices.ActiveSlot(i);
+        const ActiveSound& s = bus.voices[slot];
+        if (s.stopping) {
+            if (faintest < 0 || s.fade.GetValue() < bus.voices[faintest].fade.GetValue()) faintest = slot;
+            continue;
+        }
+
+        ++sounding;
+        if (victim < 0) {
+            victim = slot;
+            continue;
+        }
+        const ActiveSound& best = bus.voices[victim];
+        bool better;
+        switch (policy) {
+        case VoiceStealPolicy::Quietest:
+            better = s.level < best.level || (s.level == best.level && s.serial < best.serial);
+            break;
+        case VoiceStealPolicy::SameSound: {
+            // By tag: streamed plays and re-decoded sounds get an AudioData of their own
+            bool same = incomingTag != 0 && s.params.tag == incomingTag;
+            bool bestSame = incomingTag != 0 && best.params.tag == incomingTag;
+            better = same != bestSame ? same : s.serial < best.serial;
+            break;
+        }
+        default:
+            better = s.serial < best.serial;
+            break;
+        }
+        if (better) victim = slot;
+    }
+
+    if (sounding >= limit && victim >= 0) FadeOutVoice(bus.voices[victim], STEAL_FADE_MS);
+    int slot = bus.voices.Allocate();
+    if (slot >= 0) return slot;
+
+    // Every slot is taken, most of them by fades: cut the one nearest silence
+    if (faintest < 0) faintest = victim;
+    if (faintest >= 0) {
+        ActiveSound& cut = bus.voices[faintest];
+        ReleaseVoice(cut, bus.streamReader);
+        m_reclaimer.Retire(bus.streamReader, std::move(cut.data));
+    }
+    return faintest;
+}
+
+// A fade of 0 ms ends within the next block: the smoother reaches its target on its first Advance
+void AudioEngine::FadeOutVoice(ActiveSound& sound, float fadeMs) {
+    sound.stopping = true;
+    sound.fade.Init(m_sampleRate.load(std::memory_order_relaxed), fadeMs, RampShape::Linear);
+    sound.fade.SetTarget(0.0f);
+}
+
+void AudioEngine::DrainCommands(MixBus& bus) {
+    const float stopFadeMs = m_stopFadeMs.load(std::memory_order_relaxed);
+    SoundCommand cmd;
+    while (bus.commands.Pop(cmd)) {
+        switch (cmd.type) {
+        case SoundCommandType::Play: {
+            const PlayParams& params = cmd.params;
+            if (params.tag != 0 && params.retrigger != RetriggerMode::Overlap) {
+                bool wasPlaying = false;
+                for (size_t i = 0; i < bus.voices.Size(); ++i) {
+                    ActiveSound& other = bus.voices[bus.voices.ActiveSlot(i)];
+                    if (other.params.tag != params.tag || other.stopping) continue;
+                    FadeOutVoice(other, stopFadeMs);
+                    wasPlaying = true;
+                }
+                if (wasPlaying && params.retrigger == RetriggerMode::Toggle) break;
+            }
+
+            int slot = AllocateVoice(bus, params.tag);
+            if (slot >= 0) {
+                ActiveSound& sound = bus.voices[slot];
+                sound.data = std::move(cmd.data);
+                sound.cursor = 0;
+                sound.serial = bus.nextSerial++;
+                sound.level = FLT_MAX; // Never the quietest before it has played
+                sound.params = cmd.params;
+                sound.fade.Reset(1.0f);
+                sound.stopping = false;
+                sound.triggerNs = cmd.triggerNs;
+                if (sound.triggerNs != 0) sound.startNs = NowNs();
+            }
+            break;
+        }
+        case SoundCommandType::StopAll:
+            // The mixer frees each voice once its fade has run out
+            for (size_t i = 0; i < bus.voices.Size(); ++i) {
+                ActiveSound& sound = bus.voices[bus.voices.ActiveSlot(i)];
+                if (cmd.panic) FadeOutVoice(sound, 0.0f);
+                else if (!sound.stopping) FadeOutVoice(sound, stopFadeMs);
+            }
+            break;
+        case SoundCommandType::SetVolume:
+            // Nothing to hear a jump on while no voice plays
+            if (bus.voices.Size() == 0) bus.volume.Reset(cmd.volume);
+            else bus.volume.SetTarget(cmd.volume);
+            break;
+        }
+        // Set only if a Play found no slot or was a toggle that stopped its sound
+        m_reclaimer.Retire(bus.streamReader, std::move(cmd.data));
+    }
 }
 
-void AudioEngine::MixSounds(float* pOutput, unsigned int frameCount, bool isMonitor) {
-    std::unique_lock<std::mutex> lock(m_soundMutex, std::try_to_lock);
-    if (!lock.owns_lock()) return;
+unsigned int AudioEngine::MixSounds(MixBus& bus, float* const* pTargets, unsigned int frameCount) {
+    DrainCommands(bus);
+    const unsigned int channels = m_channels.load(std::memory_order_relaxed);
+    const unsigned int sampleRate = m_sampleRate.load(std::memory_order_relaxed);
 
-    float vol = m_soundVolume;
+    // The bus volume glides over the block; every voice ramps with it (and with its own fade)
+    const float volStart = bus.volume.GetValue();
+    const float volEnd = bus.volume.Advance(frameCount);
+    const size_t outSamples = (size_t)frameCount * channels;
+    const bool trackLevel = m_voiceStealPolicy.load(std::memory_order_relaxed) == VoiceStealPolicy::Quietest;
+    int64_t blockNs = 0; // Read on demand, only when a timed voice plays its first block
+    unsigned int mixed = 0;
 
-    for (auto it = m_activeSounds.begin(); it != m_activeSounds.end(); ) {
-        ActiveSound& sound = *it;
-        float* rawAudio = sound.data->samples.data();
-        size_t totalSamples = sound.data->samples.size();
+    for (size_t v = 0; v < bus.voices.Size(); ) {
+        int slot = bus.voices.ActiveSlot(v);
+        ActiveSound& sound = bus.voices[slot];
 
-        size_t* pCursor = isMonitor ? &sound.cursorMonitor : &sound.cursorCable;
+        // A voice with no target still advances, so it stays in time if it is heard again
+        const unsigned int target = SoundRouteIndex(sound.params.route);
+        float* pOutput = pTargets[target];
+        // Per-channel gain at the block's first frame and its change per frame. The fade
+        // advances even while the voice has no data yet, so a stop never waits on decoding.
+        const float fadeStart = sound.fade.GetValue();
+        const float fadeEnd = sound.fade.Advance(frameCount);
+        const bool ramping = volStart != volEnd || fadeStart != fadeEnd;
+        const float pan = channels == 2 ? std::clamp(sound.params.pan, -1.0f, 1.0f) : 0.0f;
+        const float panGain[MAX_CHANNELS] = { std::min(1.0f, 1.0f - pan), std::min(1.0f, 1.0f + pan) };
+        float gainStart[MAX_CHANNELS], gainStep[MAX_CHANNELS];
+        for (unsigned int c = 0; c < channels; ++c) {
+            gainStart[c] = volStart * fadeStart * sound.params.gain * panGain[c];
+            gainStep[c] = (volEnd * fadeEnd * sound.params.gain * panGain[c] - gainStart[c]) / frameCount;
+        }
 
-        for (unsigned int i = 0; i < frameCount; ++i) {
-            for (int c = 0; c < CHANNELS; ++c) {
-                if (*pCursor < totalSamples) {
-                    pOutput[i * CHANNELS + c] += rawAudio[*pCursor] * vol;
-                    (*pCursor)++;
+        float levelSum = 0.0f;
+        size_t levelTaps = 0;
+        size_t written = 0;
+        const bool isStream = sound.data->isStream.load(std::memory_order_acquire);
+        bool stale = isStream && !ClaimStream(sound);
+        while (!stale && written < outSamples) {
+            const void* rawAudio = nullptr;
+            size_t count = std::min(PeekVoice(sound, isStream, bus.streamReader, &rawAudio), outSamples - written);
+            if (count == 0) break; // Still decoding / buffering
+
+            // Decoded for the format before the devices changed; published with the data like 'format'
+            if (sound.data->channels != channels || sound.data->sampleRate != sampleRate) {
+                stale = true;
+                break;
+            }
+
+            // 'format' is published together with the data, so it is valid once count > 0
+            if (pOutput) {
+                const bool s16 = sound.data->format == SampleFormat::S16;
+                float* pDst = pOutput + written;
+                if (ramping) {
+                    float start[MAX_CHANNELS];
+                    const float frame = (float)(written / channels);
+                    for (unsigned int c = 0; c < channels; ++c) start[c] = gainStart[c] + gainStep[c] * frame;
+                    if (s16) MixKernels::MixAddS16Ramp(pDst, (const int16_t*)rawAudio, count, channels, start, gainStep);
+                    else MixKernels::MixAddRamp(pDst, (const float*)rawAudio, count, channels, start, gainStep);
+                } else if (pan == 0.0f) {
+                    if (s16) MixKernels::MixAddS16(pDst, (const int16_t*)rawAudio, count, gainStart[0]);
+                    else MixKernels::MixAdd(pDst, (const float*)rawAudio, count, gainStart[0]);
+                } else {
+                    if (s16) MixKernels::MixAddS16Stereo(pDst, (const int16_t*)rawAudio, count, gainStart[0], gainStart[1]);
+                    else MixKernels::MixAddStereo(pDst, (const float*)rawAudio, count, gainStart[0], gainStart[1]);
                 }
+                if (trackLevel) AccumulateLevel(rawAudio, sound.data->format, count, levelSum, levelTaps);
             }
+            written += count;
+            sound.cursor += count;
         }
+        if (levelTaps > 0) sound.level = levelSum / levelTaps * sound.params.gain;
+        else if (!pOutput) sound.level = 0.0f; // Not heard here, so the cheapest voice to steal
+        if (pOutput && written > 0) mixed |= 1u << target;
+
+        if (sound.triggerNs != 0 && written > 0) {
+            if (blockNs == 0) blockNs = NowNs();
+            TriggerTiming timing;
+            timing.triggerNs = sound.triggerNs;
+            timing.readyNs = sound.data->readyNs.load(std::memory_order_relaxed);
+            timing.voiceStartNs = sound.startNs;
+            timing.firstBlockNs = blockNs;
+            m_latency.RecordTrigger(timing);
+            sound.triggerNs = 0;
+        }
+
+        if (isStream && !stale) sound.data->stream->Consume(bus.streamReader, sound.cursor);
 
-        if (sound.cursorCable >= totalSamples && sound.cursorMonitor >= totalSamples) {
-            it = m_activeSounds.erase(it);
+        bool fadedOut = sound.stopping && fadeEnd == 0.0f;
+        if (stale || fadedOut || IsVoiceFinished(sound, bus.streamReader)) {
+            ReleaseVoice(sound, bus.streamReader);
+            m_reclaimer.Retire(bus.streamReader, std::move(sound.data));
+            bus.voices.Free(slot); // Moves the last active slot to position v
         }
         else {
-            ++it;
+            ++v;
         }
     }
+    return mixed;
 }
\ No newline at end of file
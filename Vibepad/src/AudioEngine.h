@@ -5,23 +5,141 @@
 #include <mutex>
 #include <atomic>
 #include <memory>
-#include <map>
+#include <functional>
+
+#include "SpscQueue.h"
+#include "DecoderPool.h"
+#include "AudioStream.h"
+#include "AudioCache.h"
+#include "PcmDiskCache.h"
+#include "MappedFile.h"
+#include "SampleFormat.h"
+#include "SoundRoute.h"
+#include "EngineOptions.h"
+#include "Reclaimer.h"
+#include "VoicePool.h"
+#include "StreamResampler.h"
+#include "SincResampler.h"
+#include "DriftController.h"
+#include "JitterBuffer.h"
+#include "LatencyMonitor.h"
+#include "CallbackMeter.h"
+#include "Limiter.h"
+#include "ParamSmoother.h"
+#include "Loudness.h"
 
 // Forward declarations
 struct ma_context;
 struct ma_device;
 
+// Filled progressively by a decoder thread. The mixer may only read
+// pcm[0, samplesReady); the buffer is sized up front and never reallocated
+// once published, so playback can start as soon as the first chunk lands.
 struct AudioData {
     std::vector<float> samples;
+    std::vector<int16_t> samples16; // Compact storage, used instead of 'samples' for S16
+
+    // What the mixer reads, in 'format': one of the vectors above, or read-only PCM inside
+    // 'mapping' for engine-format WAVs and disk cache hits. Both are set before the first
+    // samplesReady publish.
+    const void* pcm = nullptr;
+    SampleFormat format = SampleFormat::F32;
+    std::unique_ptr<MappedFile> mapping;
+
+    // Engine format the PCM was produced for, set before the first publish like 'format'
     unsigned int channels = 2;
     unsigned int sampleRate = 48000;
+
+    std::atomic<size_t> samplesReady{ 0 };
+    std::atomic<bool> complete{ false };
+
+    // Heap bytes owned by this entry, accounted against the cache budget (0 for mapped data)
+    std::atomic<size_t> byteSize{ 0 };
+
+    // Streaming variant: 'samples' stays empty and the voice pulls from its own
+    // decoder through 'stream', which is valid once 'isStream' is set.
+    std::shared_ptr<AudioStream> stream;
+    std::atomic<bool> isStream{ false };
+    // Mix bus only: serial + 1 of the one voice reading 'stream' (0 = none yet)
+    uint64_t streamVoice = 0;
+
+    // Cache-only marker for sounds above the stream threshold: every play opens a new stream
+    bool streamPlaceholder = false;
+
+    // Steady-clock time the first samples (or the stream) became readable, for latency stats
+    std::atomic<int64_t> readyNs{ 0 };
+};
+
+// Per-trigger mix settings
+struct PlayParams {
+    float gain = 1.0f; // Linear, on top of the bus volume (loudness normalization and the sound's own gain)
+    float pan = 0.0f;  // Stereo balance, -1 (left only) .. 1 (right only); ignored on a mono engine
+    SoundRoute route = SoundRoute::Both;
+
+    // Groups the voices of one sound for re-triggers (0 = no group, always overlaps)
+    uint64_t tag = 0;
+    RetriggerMode retrigger = RetriggerMode::Overlap;
 };
 
 struct ActiveSound {
     std::shared_ptr<AudioData> data;
-    size_t cursorCable = 0;
-    size_t cursorMonitor = 0;
-    bool finished = false;
+    size_t cursor = 0;
+    uint64_t serial = 0;  // Start order, for stealing the oldest voice
+    float level = 0.0f;   // Recent mean |sample|, tracked only for the Quietest policy
+    PlayParams params;
+    ParamSmoother fade;    // 1 while playing, gliding to 0 once stopped
+    bool stopping = false; // Freed when the fade reaches 0
+    int64_t triggerNs = 0; // Timed bus only: set until the first mixed block is recorded
+    int64_t startNs = 0;
+};
+
+enum class SoundCommandType {
+    Play,
+    StopAll,
+    SetVolume
+};
+
+// Sent from the UI thread to the audio callbacks
+struct SoundCommand {
+    SoundCommandType type = SoundCommandType::Play;
+    std::shared_ptr<AudioData> data;
+    float volume = 1.0f;
+    PlayParams params;     // Play only
+    bool panic = false;    // StopAll only: fade out within one block instead of the stop fade
+    int64_t triggerNs = 0; // When PlaySoundFile was called (0 = not timed)
+};
+
+// Sound mixing state. Everything except the command queue is owned by the one
+// device callback that mixes the bus, so the real-time path needs no lock.
+struct MixBus {
+    static constexpr size_t MAX_VOICES = 256;   // Highest runtime voice limit
+    static constexpr size_t FADING_VOICES = 64; // Extra slots where stopped and stolen voices fade out
+
+    SpscQueue<SoundCommand, 256> commands;
+    VoicePool<ActiveSound, MAX_VOICES + FADING_VOICES> voices;
+    uint64_t nextSerial = 0;
+    ParamSmoother volume;
+    int streamReader = 0; // Reader slot used on shared AudioStreams, and reclaimer lane
+};
+
+struct PreloadProgress {
+    size_t done = 0;
+    size_t total = 0;
+    size_t failed = 0;
+    double elapsedMs = 0.0; // Since Preload() was called
+};
+
+// Health of the real-time path, for the stats panel
+struct EngineStats {
+    CallbackStats capture;
+    CallbackStats cable;
+    CallbackStats monitor;
+    JitterStats mic;
+    LimiterStats cableLimiter;
+    LimiterStats monitorLimiter;
+    uint64_t droppedCommands = 0;  // Play/stop/volume commands lost to a full bus queue
+    uint64_t monitorUnderruns = 0; // Monitor blocks that ran out of cable mix and re-buffered
+    uint64_t reclaimOverflows = 0; // Finished sounds released on an audio thread because the reclaimer fell behind
 };
 
 struct DeviceInfo {
@@ -31,6 +149,13 @@ struct DeviceInfo {
 
 class AudioEngine {
 public:
+    // Invoked on a decoder thread when a sound has been fully decoded (or failed to load)
+    using DecodeCallback = std::function<void(const std::wstring& fullPath, bool success)>;
+    // Invoked on a preload thread after each file; the last call has done == total
+    using PreloadCallback = std::function<void(const PreloadProgress& progress)>;
+    // Invoked on the analysis thread with a file's integrated loudness in LUFS
+    using LoudnessCallback = std::function<void(const std::wstring& fullPath, bool success, double lufs)>;
+
     AudioEngine();
     ~AudioEngine();
 
@@ -40,25 +165,136 @@ public:
 
     void Shutdown();
 
+    // Headless mode for tests and benchmarks: no devices are opened and the
+    // caller drives the device callbacks through RenderOffline().
+    bool InitOffline(unsigned int sampleRate = 48000, unsigned int channels = 2);
+    // Runs one period: capture (if pMicInput), then cable and monitor output (if non-null)
+    void RenderOffline(const float* pMicInput, float* pCableOutput, float* pMonitorOutput, unsigned int frameCount);
+
+    // Format of the mix bus and of decoded sounds. Init adopts the cable device's native
+    // format (at most stereo) so neither decoding nor the cable needs a second conversion.
+    unsigned int GetSampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+    unsigned int GetChannels() const { return m_channels.load(std::memory_order_relaxed); }
+
     void RefreshDeviceList();
     std::vector<DeviceInfo> GetInputDevices();
     std::vector<DeviceInfo> GetOutputDevices();
 
-    void PlaySoundFile(const std::wstring& fullPath);
+    void SetDecodeCallback(DecodeCallback callback);
+
+    // Returns immediately; decoding runs on the pool and playback starts with the first chunk
+    void PlaySoundFile(const std::wstring& fullPath, const PlayParams& params = PlayParams());
+    // Plays caller-provided PCM in the engine format (see GetSampleRate/GetChannels);
+    // samplesReady/complete must already be set
+    void PlayAudioData(std::shared_ptr<AudioData> audioData, const PlayParams& params = PlayParams());
+
+    // Decodes the given files into the cache on 'threadCount' background threads (0 = one per
+    // core but one, at most 4), so the first trigger of each sound costs no more than later ones
+    void Preload(const std::vector<std::wstring>& fullPaths, unsigned int threadCount, PreloadCallback callback);
     void FreeSound(const std::wstring& fullPath);
-    void StopAllSounds();
+    // Fades every voice out over the stop fade, or within the next mixed block for a panic stop
+    void StopAllSounds(bool panic = false);
+    // Fade applied when a voice is stopped or re-triggered away (clamped to 1..500 ms)
+    void SetStopFade(float ms);
+
+    // Measures a file's EBU R128 integrated loudness on a background thread, decoding it
+    // separately from the cache; jobs run one at a time in submission order
+    void AnalyzeLoudness(const std::wstring& fullPath, LoudnessCallback callback);
 
     void SetMicVolume(float volume);
     void SetSoundVolume(float volume);
 
+    // Sounds longer than this are streamed from disk instead of cached in memory
+    void SetStreamThreshold(float seconds);
+
+    void SetCacheBudget(size_t bytes);
+    AudioCacheStats GetCacheStats();
+
+    // Persist decoded PCM under sounds/.cache so later launches skip decoding
+    void SetDiskCacheEnabled(bool enabled);
+
+    // Decode (and disk-cache) new sounds as s16 instead of f32, halving their memory
+    void SetCompactCache(bool compact);
+
+    // Resampler for sounds whose rate differs from the engine's. Applies to sounds decoded
+    // after the call; the disk cache keeps a separate entry per quality.
+    void SetDecodeQuality(DecodeQuality quality);
+
+    // Simultaneous voices per output (1..MixBus::MAX_VOICES). A trigger beyond the
+    // limit fades out the voice picked by the steal policy.
+    void SetVoiceLimit(size_t voices);
+    void SetVoiceStealPolicy(VoiceStealPolicy policy);
+
+    // Output limiters (both buses): peaks above the ceiling are caught ahead of time and the gain
+    // recovers over the release time
+    void SetLimiter(float ceilingDb, float releaseMs);
+
+    // Drift of the monitor device's clock against the cable device's (the master timeline)
+    ClockStats GetClockStats();
+
+    // Latency, clock drift and glitch counters of the mic passthrough
+    JitterStats GetMicJitterStats();
+
+    // Callback timing and xrun counters. resetWindow restarts the span that averages and peaks cover.
+    EngineStats GetEngineStats(bool resetWindow);
+
+    // Trigger-to-audio and mic buffering percentiles, measured on the cable output
+    LatencyReport GetLatencyReport();
+    void ResetLatencyStats();
+    // Also writes every measurement as a CSV row (from a background thread)
+    bool StartLatencyLog(const std::wstring& path);
+    void StopLatencyLog();
+
     void OnCapture(const void* pInput, unsigned int frameCount);
     void OnCableProcess(void* pOutput, unsigned int frameCount);
     void OnMonitorProcess(void* pOutput, unsigned int frameCount);
 
 private:
-    void MixSounds(float* pOutput, unsigned int frameCount, bool isMonitor);
+    void ApplyFormat(unsigned int sampleRate, unsigned int channels);
+    bool InitMicBuffer();
+    bool InitMonitorRing();
+    void WriteMonitorRing(const float* pSrc, unsigned int frameCount);
+    void ReadMonitorRing(float* pDst, unsigned int frameCount);
+    void ReadMic(float* pDst, unsigned int frameCount);
+    void ResetClocks();
+    bool DecodeFile(const std::wstring& fullPath, const std::shared_ptr<AudioData>& audioData);
+    bool OpenStream(const std::wstring& fullPath, const std::shared_ptr<AudioData>& audioData);
+    void PostCommand(const SoundCommand& cmd);
+    void DrainCommands(MixBus& bus);
+    int AllocateVoice(MixBus& bus, uint64_t incomingTag);
+    void FadeOutVoice(ActiveSound& sound, float fadeMs);
+    // Adds each voice into pTargets[SoundRouteIndex(route)], skipping voices whose target is null.
+    // Returns a bit per target that received a voice.
+    unsigned int MixSounds(MixBus& bus, float* const* pTargets, unsigned int frameCount);
+
+    AudioCache m_audioCache;
+    PcmDiskCache m_diskCache;
+
+    DecoderPool m_decoderPool;
+    DecodeCallback m_decodeCallback;
+
+    // Separate from m_decoderPool so warm-up never delays a hotkey's decode
+    DecoderPool m_preloadPool;
+    std::atomic<size_t> m_preloadDone{ 0 };
+    std::atomic<size_t> m_preloadFailed{ 0 };
+
+    // Loudness analysis; one thread, so it never competes with decoding for more than a core
+    DecoderPool m_analysisPool;
 
-    std::map<std::wstring, std::shared_ptr<AudioData>> m_audioCache;
+    StreamPrefetcher m_prefetcher;
+
+    // Finished voices are released here, never on the audio threads
+    Reclaimer m_reclaimer;
+    // Changed only while the devices are stopped; decoder threads read them per job
+    std::atomic<unsigned int> m_sampleRate{ 48000 };
+    std::atomic<unsigned int> m_channels{ 2 };
+
+    std::atomic<float> m_streamThresholdSeconds{ 30.0f };
+    std::atomic<bool> m_compactCache{ false };
+    std::atomic<DecodeQuality> m_decodeQuality{ DecodeQuality::Polyphase };
+    std::atomic<size_t> m_voiceLimit{ 64 };
+    std::atomic<VoiceStealPolicy> m_voiceStealPolicy{ VoiceStealPolicy::Oldest };
+    std::atomic<float> m_stopFadeMs{ 20.0f };
 
     ma_context* m_pContext = nullptr;
     ma_device* m_pCaptureDevice = nullptr;
@@ -68,13 +304,51 @@ private:
     void* m_pMicBuffer = nullptr;
     void* m_pAudioBufferData = nullptr; // Raw buffer data
 
+    // Mic passthrough: the cable reads the ring through a resampler whose rate the
+    // jitter buffer trims (latency and capture/cable clock drift), instead of seeking
+    // over stale audio. Cable audio thread only, apart from Reset in InitMicBuffer.
+    JitterBuffer m_micJitter;
+    StreamResampler m_micResampler;
+    std::vector<float> m_micBlock; // Resampler output, preallocated
+    // Voices routed to one output only, kept apart from the shared mix; RESAMPLER_BLOCK_FRAMES each
+    std::vector<float> m_cableOnlyMix;
+    std::vector<float> m_monitorOnlyMix;
+    std::vector<float> m_micHold;  // Last frame read from the ring, where an underrun fade starts
+    bool m_micPlaying = false;     // False while the jitter buffer refills; the next block fades in
+    ParamSmoother m_micGain;       // Mic volume as applied, gliding toward m_micVolume
+
     bool m_isInitialized = false;
+    bool m_isOffline = false;
 
     std::atomic<float> m_micVolume{ 1.0f };
-    std::atomic<float> m_soundVolume{ 1.0f };
 
-    std::vector<ActiveSound> m_activeSounds;
-    std::mutex m_soundMutex;
+    // Sounds are mixed once, by the cable callback, which also copies the mix into
+    // m_pMonitorRing. The cable is the master timeline: the monitor reads the ring
+    // through a resampler whose ratio keeps its position locked to the cable's.
+    MixBus m_mixBus;
+    uint64_t m_cableFrames = 0; // Cable audio thread only
+    StreamResampler m_monitorResampler;
+    DriftController m_monitorDrift;
+
+    void* m_pMonitorRing = nullptr;     // ma_rb of mixed frames, cable -> monitor
+    void* m_pMonitorRingData = nullptr;
+    std::atomic<unsigned int> m_cableBlockFrames{ 0 }; // Last cable period, sizes the monitor's buffering
+    std::atomic<bool> m_monitorResync{ false };        // Set by the cable when the ring overflowed
+    std::atomic<uint64_t> m_monitorUnderruns{ 0 };
+    bool m_monitorPlaying = false; // Monitor audio thread only; false while the ring refills
+    // Set while the cable device isn't running: the monitor then mixes the bus itself.
+    // Changed only with the devices stopped (or between offline periods).
+    std::atomic<bool> m_monitorMixes{ false };
+
+    // Last stage of each output; audio threads only, apart from their parameters
+    Limiter m_cableLimiter;
+    Limiter m_monitorLimiter;
+
+    LatencyMonitor m_latency;
+    CallbackMeter m_captureMeter;
+    CallbackMeter m_cableMeter;
+    CallbackMeter m_monitorMeter;
+    std::atomic<uint64_t> m_droppedCommands{ 0 };
 
     std::vector<DeviceInfo> m_inputDevices;
     std::vector<DeviceInfo> m_outputDevices;
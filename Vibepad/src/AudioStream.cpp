@@ -0,0 +1,167 @@
+#include "AudioStream.h"
+#include <algorithm>
+#include <cstdint>
+
+#include "../lib/miniaudio.h"
+
+// A reader that hasn't started by then is assumed to belong to a stopped device
+const std::chrono::milliseconds READER_START_GRACE(500);
+const std::chrono::milliseconds PREFETCH_INTERVAL(10);
+
+// -----------------------------------------------------------------------------
+// AUDIO STREAM
+// -----------------------------------------------------------------------------
+AudioStream::AudioStream(unsigned int channels, unsigned int sampleRate, size_t capacityFrames)
+    : m_channels(channels), m_sampleRate(sampleRate) {
+    m_ring.resize(capacityFrames * channels);
+    for (int r = 0; r < MAX_READERS; ++r) {
+        m_readPos[r].store(0);
+        m_readerState[r].store(READER_IDLE);
+    }
+}
+
+AudioStream::~AudioStream() {
+    if (m_pDecoder) {
+        ma_decoder_uninit(m_pDecoder);
+        delete m_pDecoder;
+    }
+}
+
+bool AudioStream::Open(const std::string& pathUtf8) {
+    m_pDecoder = new ma_decoder();
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, m_channels, m_sampleRate);
+    if (ma_decoder_init_file(pathUtf8.c_str(), &config, m_pDecoder) != MA_SUCCESS) {
+        delete m_pDecoder;
+        m_pDecoder = nullptr;
+        m_eof.store(true, std::memory_order_release);
+        return false;
+    }
+
+    m_openedAt = std::chrono::steady_clock::now();
+    Fill();
+    return m_writePos.load(std::memory_order_relaxed) > 0;
+}
+
+// The writer may run one ring ahead of the slowest active reader
+size_t AudioStream::WriteLimit() {
+    bool young = std::chrono::steady_clock::now() - m_openedAt < READER_START_GRACE;
+    size_t base = SIZE_MAX;
+
+    for (int r = 0; r < MAX_READERS; ++r) {
+        int state = m_readerState[r].load(std::memory_order_acquire);
+        if (state == READER_IDLE && !young) {
+            int expected = READER_IDLE;
+            if (m_readerState[r].compare_exchange_strong(expected, READER_DONE)) continue;
+            state = expected;
+        }
+        if (state == READER_ACTIVE) base = std::min(base, m_readPos[r].load(std::memory_order_acquire));
+        else if (state == READER_IDLE) base = 0; // Will start from the beginning
+    }
+
+    if (base == SIZE_MAX) return m_writePos.load(std::memory_order_relaxed); // Nobody left to read
+    return base + m_ring.size();
+}
+
+bool AudioStream::Fill() {
+    if (!m_pDecoder || m_eof.load(std::memory_order_relaxed)) return false;
+
+    size_t writePos = m_writePos.load(std::memory_order_relaxed);
+    size_t limit = WriteLimit();
+    bool wrote = false;
+
+    while (writePos < limit) {
+        size_t index = writePos % m_ring.size();
+        size_t samples = std::min(limit - writePos, m_ring.size() - index);
+        ma_uint64 framesRead = 0;
+        ma_decoder_read_pcm_frames(m_pDecoder, &m_ring[index], samples / m_channels, &framesRead);
+        if (framesRead == 0) {
+            m_eof.store(true, std::memory_order_release);
+            break;
+        }
+        writePos += (size_t)framesRead * m_channels;
+        m_writePos.store(writePos, std::memory_order_release);
+        wrote = true;
+    }
+    return wrote;
+}
+
+size_t AudioStream::Peek(int reader, size_t pos, const float** ppData) {
+    int state = m_readerState[reader].load(std::memory_order_acquire);
+    if (state == READER_IDLE) {
+        m_readerState[reader].compare_exchange_strong(state, READER_ACTIVE);
+        state = m_readerState[reader].load(std::memory_order_acquire);
+    }
+    if (state != READER_ACTIVE) return 0;
+
+    size_t writePos = m_writePos.load(std::memory_order_acquire);
+    if (pos >= writePos) return 0;
+
+    size_t index = pos % m_ring.size();
+    *ppData = &m_ring[index];
+    return std::min(writePos - pos, m_ring.size() - index);
+}
+
+void AudioStream::Consume(int reader, size_t pos) {
+    m_readPos[reader].store(pos, std::memory_order_release);
+}
+
+void AudioStream::ReleaseReader(int reader) {
+    m_readerState[reader].store(READER_DONE, std::memory_order_release);
+}
+
+bool AudioStream::IsFinished(int reader, size_t pos) const {
+    if (m_readerState[reader].load(std::memory_order_acquire) == READER_DONE) return true;
+    bool eof = m_eof.load(std::memory_order_acquire);
+    return eof && pos >= m_writePos.load(std::memory_order_acquire);
+}
+
+// -----------------------------------------------------------------------------
+// PREFETCH THREAD
+// -----------------------------------------------------------------------------
+StreamPrefetcher::~StreamPrefetcher() {
+    Stop();
+}
+
+void StreamPrefetcher::Start() {
+    Stop();
+    m_stopping = false;
+    m_thread = std::thread(&StreamPrefetcher::ThreadLoop, this);
+}
+
+void StreamPrefetcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+
+    m_pending.clear();
+    m_streams.clear();
+}
+
+void StreamPrefetcher::Add(std::shared_ptr<AudioStream> stream) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::move(stream));
+    }
+    m_cv.notify_one();
+}
+
+void StreamPrefetcher::ThreadLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, PREFETCH_INTERVAL, [this] { return m_stopping || !m_pending.empty(); });
+            if (m_stopping) return;
+            for (auto& s : m_pending) m_streams.push_back(std::move(s));
+            m_pending.clear();
+        }
+
+        for (auto& s : m_streams) s->Fill();
+
+        // Only this thread still holds it: every voice is gone, so close the decoder here
+        m_streams.erase(std::remove_if(m_streams.begin(), m_streams.end(),
+            [](const std::shared_ptr<AudioStream>& s) { return s.use_count() == 1; }), m_streams.end());
+    }
+}
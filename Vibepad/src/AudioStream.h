@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+struct ma_decoder;
+
+// A decoder feeding a prefetch ring buffer, used for sounds too long to keep
+// fully decoded in memory. One background thread writes, and up to MAX_READERS
+// audio callbacks read, each at its own cursor. Positions are absolute sample
+// indices (interleaved floats) from the start of the file.
+class AudioStream {
+public:
+    static const int MAX_READERS = 1; // The mix bus; kept as a slot array so more buses can share a stream
+
+    AudioStream(unsigned int channels, unsigned int sampleRate, size_t capacityFrames);
+    ~AudioStream();
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    // Non-RT: opens the decoder and prefills the first part of the ring
+    bool Open(const std::string& pathUtf8);
+
+    // Prefetch thread: decodes into free ring space, returns true if anything was written
+    bool Fill();
+
+    // Audio thread: contiguous readable samples starting at 'pos' (0 while buffering)
+    size_t Peek(int reader, size_t pos, const float** ppData);
+    void Consume(int reader, size_t pos);
+    void ReleaseReader(int reader);
+    bool IsFinished(int reader, size_t pos) const;
+
+private:
+    enum ReaderState { READER_IDLE, READER_ACTIVE, READER_DONE };
+
+    size_t WriteLimit();
+
+    ma_decoder* m_pDecoder = nullptr;
+    unsigned int m_channels;
+    unsigned int m_sampleRate;
+
+    std::vector<float> m_ring;
+    std::atomic<size_t> m_writePos{ 0 };
+    std::atomic<bool> m_eof{ false };
+
+    std::atomic<size_t> m_readPos[MAX_READERS];
+    std::atomic<int> m_readerState[MAX_READERS];
+
+    std::chrono::steady_clock::time_point m_openedAt;
+};
+
+// Background thread that keeps every live AudioStream topped up.
+// Streams are released here once no voice references them any more.
+class StreamPrefetcher {
+public:
+    StreamPrefetcher() = default;
+    ~StreamPrefetcher();
+
+    void Start();
+    void Stop();
+
+    void Add(std::shared_ptr<AudioStream> stream);
+
+private:
+    void ThreadLoop();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::shared_ptr<AudioStream>> m_pending;
+    std::vector<std::shared_ptr<AudioStream>> m_streams;
+    bool m_stopping = false;
+};
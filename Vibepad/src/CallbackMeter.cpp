@@ -0,0 +1,59 @@
+#include "CallbackMeter.h"
+
+#include <chrono>
+
+int64_t CallbackMeter::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CallbackMeter::Record(int64_t startNs, int64_t endNs, unsigned int frameCount) {
+    int64_t durationNs = endNs - startNs;
+    int64_t periodNs = (int64_t)(frameCount * 1e9 / m_sampleRate);
+    double load = periodNs > 0 ? (double)durationNs / (double)periodNs : 0.0;
+
+    m_calls.fetch_add(1, std::memory_order_relaxed);
+    if (durationNs > periodNs) m_overBudget.fetch_add(1, std::memory_order_relaxed);
+    if (m_lastStartNs != 0 && (startNs - m_lastStartNs) * 2 > m_lastPeriodNs * 3) {
+        m_lateStarts.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_lastStartNs = startNs;
+    m_lastPeriodNs = periodNs;
+
+    m_windowCalls.fetch_add(1, std::memory_order_relaxed);
+    m_windowNs.fetch_add(durationNs, std::memory_order_relaxed);
+    m_windowBudgetNs.fetch_add(periodNs, std::memory_order_relaxed);
+    // Only this thread raises the peaks; a reset racing with it at worst loses one sample
+    if (durationNs > m_peakNs.load(std::memory_order_relaxed)) m_peakNs.store(durationNs, std::memory_order_relaxed);
+    if (load > m_peakLoad.load(std::memory_order_relaxed)) m_peakLoad.store(load, std::memory_order_relaxed);
+}
+
+CallbackStats CallbackMeter::GetStats(bool resetWindow) {
+    CallbackStats stats;
+    stats.calls = m_calls.load(std::memory_order_relaxed);
+    stats.overBudget = m_overBudget.load(std::memory_order_relaxed);
+    stats.lateStarts = m_lateStarts.load(std::memory_order_relaxed);
+
+    uint64_t calls;
+    int64_t totalNs, budgetNs, peakNs;
+    double peakLoad;
+    if (resetWindow) {
+        calls = m_windowCalls.exchange(0, std::memory_order_relaxed);
+        totalNs = m_windowNs.exchange(0, std::memory_order_relaxed);
+        budgetNs = m_windowBudgetNs.exchange(0, std::memory_order_relaxed);
+        peakNs = m_peakNs.exchange(0, std::memory_order_relaxed);
+        peakLoad = m_peakLoad.exchange(0.0, std::memory_order_relaxed);
+    }
+    else {
+        calls = m_windowCalls.load(std::memory_order_relaxed);
+        totalNs = m_windowNs.load(std::memory_order_relaxed);
+        budgetNs = m_windowBudgetNs.load(std::memory_order_relaxed);
+        peakNs = m_peakNs.load(std::memory_order_relaxed);
+        peakLoad = m_peakLoad.load(std::memory_order_relaxed);
+    }
+
+    if (calls > 0) stats.avgMs = totalNs / 1e6 / (double)calls;
+    if (budgetNs > 0) stats.avgLoad = (double)totalNs / (double)budgetNs;
+    stats.peakMs = peakNs / 1e6;
+    stats.peakLoad = peakLoad;
+    return stats;
+}
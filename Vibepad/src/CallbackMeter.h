@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct CallbackStats {
+    uint64_t calls = 0;
+    uint64_t overBudget = 0;  // Callbacks that ran longer than the audio they produced
+    uint64_t lateStarts = 0;  // Callbacks that started over 1.5 periods after the previous one (device xrun or stall)
+
+    // Since the previous GetStats(true)
+    double avgMs = 0.0;
+    double peakMs = 0.0;
+    double avgLoad = 0.0;     // Callback duration / block period; 1.0 means the deadline is missed
+    double peakLoad = 0.0;
+};
+
+// Timing of one device callback. The callback thread records with relaxed
+// atomics only; a UI timer reads the stats, optionally restarting the window
+// that averages and peaks cover.
+class CallbackMeter {
+public:
+    explicit CallbackMeter(double sampleRate) : m_sampleRate(sampleRate) {}
+    // While the callback is not running
+    void SetSampleRate(double sampleRate) { m_sampleRate = sampleRate; }
+
+    // Times the enclosing callback
+    class Scope {
+    public:
+        Scope(CallbackMeter& meter, unsigned int frameCount) : m_meter(meter), m_frameCount(frameCount), m_startNs(Now()) {}
+        ~Scope() { m_meter.Record(m_startNs, Now(), m_frameCount); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CallbackMeter& m_meter;
+        unsigned int m_frameCount;
+        int64_t m_startNs;
+    };
+
+    void Record(int64_t startNs, int64_t endNs, unsigned int frameCount);
+    CallbackStats GetStats(bool resetWindow);
+
+    static int64_t Now();
+
+private:
+    double m_sampleRate;
+    int64_t m_lastStartNs = 0;  // Callback thread only
+    int64_t m_lastPeriodNs = 0;
+
+    std::atomic<uint64_t> m_calls{ 0 };
+    std::atomic<uint64_t> m_overBudget{ 0 };
+    std::atomic<uint64_t> m_lateStarts{ 0 };
+
+    std::atomic<uint64_t> m_windowCalls{ 0 };
+    std::atomic<int64_t> m_windowNs{ 0 };
+    std::atomic<int64_t> m_windowBudgetNs{ 0 };
+    std::atomic<int64_t> m_peakNs{ 0 };
+    std::atomic<double> m_peakLoad{ 0.0 };
+};
@@ -1,12 +1,87 @@
 #include "Config.h"
 #include "Utils.h"
 #include <fstream>
+#include <algorithm>
 #include <iostream>
+#include <cmath>
 #include "../lib/json.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
+// Quiet sounds are raised at most this much; the rest is left to the sound volume
+const float MAX_NORMALIZATION_BOOST_DB = 12.0f;
+
+static PreloadMode PreloadModeFromString(const std::string& s) {
+    if (s == "off") return PreloadMode::Off;
+    if (s == "all") return PreloadMode::All;
+    return PreloadMode::Hotkeys;
+}
+
+static std::string PreloadModeToString(PreloadMode mode) {
+    switch (mode) {
+    case PreloadMode::Off: return "off";
+    case PreloadMode::All: return "all";
+    default: return "hotkeys";
+    }
+}
+
+static VoiceStealPolicy VoiceStealPolicyFromString(const std::string& s) {
+    if (s == "quietest") return VoiceStealPolicy::Quietest;
+    if (s == "same_sound") return VoiceStealPolicy::SameSound;
+    return VoiceStealPolicy::Oldest;
+}
+
+static std::string VoiceStealPolicyToString(VoiceStealPolicy policy) {
+    switch (policy) {
+    case VoiceStealPolicy::Quietest: return "quietest";
+    case VoiceStealPolicy::SameSound: return "same_sound";
+    default: return "oldest";
+    }
+}
+
+static DecodeQuality DecodeQualityFromString(const std::string& s) {
+    if (s == "linear") return DecodeQuality::Linear;
+    if (s == "sinc") return DecodeQuality::Sinc;
+    return DecodeQuality::Polyphase;
+}
+
+static std::string DecodeQualityToString(DecodeQuality quality) {
+    switch (quality) {
+    case DecodeQuality::Linear: return "linear";
+    case DecodeQuality::Sinc: return "sinc";
+    default: return "polyphase";
+    }
+}
+
+static SoundRoute SoundRouteFromString(const std::string& s) {
+    if (s == "cable") return SoundRoute::Cable;
+    if (s == "monitor") return SoundRoute::Monitor;
+    return SoundRoute::Both;
+}
+
+static std::string SoundRouteToString(SoundRoute route) {
+    switch (route) {
+    case SoundRoute::Cable: return "cable";
+    case SoundRoute::Monitor: return "monitor";
+    default: return "both";
+    }
+}
+
+static RetriggerMode RetriggerModeFromString(const std::string& s) {
+    if (s == "toggle") return RetriggerMode::Toggle;
+    if (s == "restart") return RetriggerMode::Restart;
+    return RetriggerMode::Overlap;
+}
+
+static std::string RetriggerModeToString(RetriggerMode mode) {
+    switch (mode) {
+    case RetriggerMode::Toggle: return "toggle";
+    case RetriggerMode::Restart: return "restart";
+    default: return "overlap";
+    }
+}
+
 std::wstring SoundEntry::GetFullPath() const {
     fs::path p = fs::current_path() / "sounds" / filename;
     return p.wstring();
@@ -36,6 +111,21 @@ void ConfigManager::Load() {
         m_monitorDeviceId = j.value("monitor_device_id", "");
         m_micVolume = j.value("mic_volume", 1.0f);
         m_soundVolume = j.value("sound_volume", 1.0f);
+        m_streamThresholdSeconds = j.value("stream_threshold_seconds", 30.0f);
+        m_cacheBudgetMb = j.value("cache_budget_mb", 512);
+        m_diskCache = j.value("disk_cache", true);
+        m_compactCache = j.value("compact_cache", false);
+        m_decodeQuality = DecodeQualityFromString(j.value("resample_quality", "polyphase"));
+        m_maxVoices = j.value("max_voices", 64);
+        m_voiceStealPolicy = VoiceStealPolicyFromString(j.value("voice_steal", "oldest"));
+        m_limiterCeilingDb = j.value("limiter_ceiling_db", -1.0f);
+        m_limiterReleaseMs = j.value("limiter_release_ms", 100.0f);
+        m_loudnessNormalization = j.value("loudness_normalization", true);
+        m_loudnessTargetLufs = j.value("loudness_target_lufs", -18.0f);
+        m_stopFadeMs = j.value("stop_fade_ms", 20.0f);
+        m_latencyLog = j.value("latency_log", "");
+        m_preloadMode = PreloadModeFromString(j.value("preload_mode", "hotkeys"));
+        m_preloadThreads = j.value("preload_threads", 0);
 
         m_sounds.clear();
         if (j.contains("sounds") && j["sounds"].is_array()) {
@@ -45,6 +135,14 @@ void ConfigManager::Load() {
                 s.filename = Utils::Utf8ToWide(item.value("filename", ""));
                 s.hotkey = item.value("hotkey", 0);
                 s.modifiers = item.value("modifiers", 0);
+                s.gainDb = item.value("gain_db", 0.0f);
+                s.pan = std::clamp(item.value("pan", 0.0f), -1.0f, 1.0f);
+                s.route = SoundRouteFromString(item.value("route", "both"));
+                s.retrigger = RetriggerModeFromString(item.value("retrigger", "overlap"));
+                if (item.contains("loudness_lufs") && item["loudness_lufs"].is_number()) {
+                    s.loudnessKnown = true;
+                    s.loudnessLufs = item["loudness_lufs"].get<float>();
+                }
                 if (!s.filename.empty()) m_sounds.push_back(s);
             }
         }
@@ -61,6 +159,21 @@ void ConfigManager::Save() {
     j["monitor_device_id"] = m_monitorDeviceId;
     j["mic_volume"] = m_micVolume;
     j["sound_volume"] = m_soundVolume;
+    j["stream_threshold_seconds"] = m_streamThresholdSeconds;
+    j["cache_budget_mb"] = m_cacheBudgetMb;
+    j["disk_cache"] = m_diskCache;
+    j["compact_cache"] = m_compactCache;
+    j["resample_quality"] = DecodeQualityToString(m_decodeQuality);
+    j["max_voices"] = m_maxVoices;
+    j["voice_steal"] = VoiceStealPolicyToString(m_voiceStealPolicy);
+    j["limiter_ceiling_db"] = m_limiterCeilingDb;
+    j["limiter_release_ms"] = m_limiterReleaseMs;
+    j["loudness_normalization"] = m_loudnessNormalization;
+    j["loudness_target_lufs"] = m_loudnessTargetLufs;
+    j["stop_fade_ms"] = m_stopFadeMs;
+    j["latency_log"] = m_latencyLog;
+    j["preload_mode"] = PreloadModeToString(m_preloadMode);
+    j["preload_threads"] = m_preloadThreads;
 
     j["sounds"] = json::array();
     for (const auto& s : m_sounds) {
@@ -69,6 +182,11 @@ void ConfigManager::Save() {
         sJson["filename"] = Utils::WideToUtf8(s.filename);
         sJson["hotkey"] = s.hotkey;
         sJson["modifiers"] = s.modifiers;
+        sJson["gain_db"] = s.gainDb;
+        sJson["pan"] = s.pan;
+        sJson["route"] = SoundRouteToString(s.route);
+        sJson["retrigger"] = RetriggerModeToString(s.retrigger);
+        if (s.loudnessKnown) sJson["loudness_lufs"] = s.loudnessLufs;
         j["sounds"].push_back(sJson);
     }
 
@@ -136,6 +254,23 @@ void ConfigManager::SetSoundHotkey(int index, int vkCode, int mods) {
     }
 }
 
+void ConfigManager::SetSoundLoudness(const std::wstring& filename, float lufs) {
+    for (auto& s : m_sounds) {
+        if (s.filename != filename) continue;
+        s.loudnessKnown = true;
+        s.loudnessLufs = lufs;
+        return;
+    }
+}
+
+float ConfigManager::GetSoundGain(const SoundEntry& sound) const {
+    float db = sound.gainDb;
+    if (m_loudnessNormalization && sound.loudnessKnown) {
+        db += std::min(m_loudnessTargetLufs - sound.loudnessLufs, MAX_NORMALIZATION_BOOST_DB);
+    }
+    return std::pow(10.0f, db / 20.0f);
+}
+
 const std::vector<SoundEntry>& ConfigManager::GetSounds() const { return m_sounds; }
 
 std::string ConfigManager::GetInputDeviceId() const { return m_inputDeviceId; }
@@ -151,4 +286,21 @@ float ConfigManager::GetMicVolume() const { return m_micVolume; }
 void ConfigManager::SetMicVolume(float vol) { m_micVolume = vol; }
 
 float ConfigManager::GetSoundVolume() const { return m_soundVolume; }
-void ConfigManager::SetSoundVolume(float vol) { m_soundVolume = vol; }
\ No newline at end of file
+void ConfigManager::SetSoundVolume(float vol) { m_soundVolume = vol; }
+
+float ConfigManager::GetStreamThreshold() const { return m_streamThresholdSeconds; }
+size_t ConfigManager::GetCacheBudgetBytes() const { return (size_t)std::max(m_cacheBudgetMb, 0) * 1024 * 1024; }
+bool ConfigManager::GetDiskCacheEnabled() const { return m_diskCache; }
+bool ConfigManager::GetCompactCache() const { return m_compactCache; }
+DecodeQuality ConfigManager::GetDecodeQuality() const { return m_decodeQuality; }
+int ConfigManager::GetMaxVoices() const { return m_maxVoices; }
+std::wstring ConfigManager::GetLatencyLogPath() const { return Utils::Utf8ToWide(m_latencyLog); }
+VoiceStealPolicy ConfigManager::GetVoiceStealPolicy() const { return m_voiceStealPolicy; }
+float ConfigManager::GetLimiterCeilingDb() const { return m_limiterCeilingDb; }
+float ConfigManager::GetLimiterReleaseMs() const { return m_limiterReleaseMs; }
+bool ConfigManager::GetLoudnessNormalization() const { return m_loudnessNormalization; }
+float ConfigManager::GetLoudnessTargetLufs() const { return m_loudnessTargetLufs; }
+float ConfigManager::GetStopFadeMs() const { return m_stopFadeMs; }
+
+PreloadMode ConfigManager::GetPreloadMode() const { return m_preloadMode; }
+int ConfigManager::GetPreloadThreads() const { return m_preloadThreads; }
\ No newline at end of file
@@ -4,12 +4,30 @@
 #include <vector>
 #include <filesystem>
 
+#include "EngineOptions.h"
+#include "SoundRoute.h"
+
+enum class PreloadMode {
+    Off,
+    Hotkeys, // Only sounds bound to a hotkey
+    All
+};
+
 struct SoundEntry {
     std::wstring name;
     std::wstring filename;
     int hotkey = 0;
     int modifiers = 0;
 
+    float gainDb = 0.0f;
+    float pan = 0.0f; // -1 (left) .. 1 (right)
+    SoundRoute route = SoundRoute::Both;
+    RetriggerMode retrigger = RetriggerMode::Overlap; // Hotkey re-press while the sound still plays
+
+    // Integrated loudness (EBU R128), measured once in the background and kept in config.json
+    bool loudnessKnown = false;
+    float loudnessLufs = 0.0f;
+
     std::wstring GetFullPath() const;
 };
 
@@ -24,6 +42,13 @@ public:
     bool AddSound(const std::wstring& originalPath, const std::wstring& displayName);
     void RemoveSound(int index);
     void SetSoundHotkey(int index, int vkCode, int mods);
+    // By filename, since the list may have changed while the file was being analyzed.
+    // Not saved here: the caller saves once a batch of measurements is done.
+    void SetSoundLoudness(const std::wstring& filename, float lufs);
+
+    // Linear playback gain: the sound's own gain plus the step to the loudness target
+    // (when it has been measured and normalization is on)
+    float GetSoundGain(const SoundEntry& sound) const;
 
     const std::vector<SoundEntry>& GetSounds() const;
 
@@ -42,6 +67,23 @@ public:
     float GetSoundVolume() const;
     void SetSoundVolume(float vol);
 
+    float GetStreamThreshold() const;
+    size_t GetCacheBudgetBytes() const;
+    bool GetDiskCacheEnabled() const;
+    bool GetCompactCache() const;
+    DecodeQuality GetDecodeQuality() const;
+    int GetMaxVoices() const;
+    VoiceStealPolicy GetVoiceStealPolicy() const;
+    float GetLimiterCeilingDb() const;
+    float GetLimiterReleaseMs() const;
+    bool GetLoudnessNormalization() const;
+    float GetLoudnessTargetLufs() const;
+    float GetStopFadeMs() const;
+    std::wstring GetLatencyLogPath() const; // Empty = no latency CSV
+
+    PreloadMode GetPreloadMode() const;
+    int GetPreloadThreads() const;
+
 private:
     std::vector<SoundEntry> m_sounds;
 
@@ -51,6 +93,21 @@ private:
 
     float m_micVolume = 1.0f;
     float m_soundVolume = 1.0f;
+    float m_streamThresholdSeconds = 30.0f;
+    int m_cacheBudgetMb = 512;
+    bool m_diskCache = true;
+    bool m_compactCache = false; // Store decoded sounds as s16
+    DecodeQuality m_decodeQuality = DecodeQuality::Polyphase;
+    int m_maxVoices = 64;
+    VoiceStealPolicy m_voiceStealPolicy = VoiceStealPolicy::Oldest;
+    float m_limiterCeilingDb = -1.0f;
+    float m_limiterReleaseMs = 100.0f;
+    bool m_loudnessNormalization = true;
+    float m_loudnessTargetLufs = -18.0f;
+    float m_stopFadeMs = 20.0f;
+    std::string m_latencyLog;
+    PreloadMode m_preloadMode = PreloadMode::Hotkeys;
+    int m_preloadThreads = 0; // 0 = auto
 
     const std::wstring SOUNDS_DIR = L"sounds";
     const std::wstring CONFIG_FILE = L"config.json";
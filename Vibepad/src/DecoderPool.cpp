@@ -0,0 +1,52 @@
+#include "DecoderPool.h"
+
+DecoderPool::~DecoderPool() {
+    Stop();
+}
+
+void DecoderPool::Start(unsigned int threadCount) {
+    Stop();
+    if (threadCount == 0) threadCount = 1;
+
+    m_stopping = false;
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&DecoderPool::WorkerLoop, this);
+    }
+}
+
+void DecoderPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_cv.notify_all();
+
+    for (auto& t : m_workers) {
+        if (t.joinable()) t.join();
+    }
+    m_workers.clear();
+}
+
+void DecoderPool::Submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+void DecoderPool::WorkerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Small fixed-size thread pool used to decode audio files off the UI thread.
+class DecoderPool {
+public:
+    using Job = std::function<void()>;
+
+    DecoderPool() = default;
+    ~DecoderPool();
+
+    DecoderPool(const DecoderPool&) = delete;
+    DecoderPool& operator=(const DecoderPool&) = delete;
+
+    void Start(unsigned int threadCount);
+    // Drops pending jobs and joins the workers (running jobs finish first)
+    void Stop();
+
+    void Submit(Job job);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Job> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+};
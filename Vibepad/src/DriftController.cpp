@@ -0,0 +1,85 @@
+#include "DriftController.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Loop tuning for ~10 ms callbacks: error in frames, time in seconds. About a
+// 5 s, near-critically damped response; callback jitter is smoothed out first.
+static const double ERROR_FILTER = 0.05;            // One-pole smoothing per block
+static const double KP = 4e-6;                      // Ratio correction per frame of error
+static const double KI = 2e-7;                      // Integral gain, per frame-second
+static const double MAX_CORRECTION = 1e-3;          // 1000 ppm, far beyond real device drift
+static const int64_t MASTER_STALE_NS = 200000000;   // Master silent this long: unlock
+static const double RELOCK_SECONDS = 0.5;           // Larger jumps (device restarts, dropouts) relock
+
+void DriftController::PublishMaster(uint64_t frames, int64_t timeNs) {
+    uint32_t seq = m_masterSeq.load(std::memory_order_relaxed);
+    m_masterSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_masterFrames.store(frames, std::memory_order_relaxed);
+    m_masterTimeNs.store(timeNs, std::memory_order_relaxed);
+    m_masterSeq.store(seq + 2, std::memory_order_release);
+}
+
+bool DriftController::ReadMaster(uint64_t& frames, int64_t& timeNs) const {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint32_t before = m_masterSeq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        frames = m_masterFrames.load(std::memory_order_relaxed);
+        timeNs = m_masterTimeNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_masterSeq.load(std::memory_order_relaxed) == before) return before != 0;
+    }
+    return false;
+}
+
+double DriftController::Update(double followerPosition, int64_t timeNs, unsigned int frameCount) {
+    if (m_resetRequested.exchange(false, std::memory_order_acquire)) m_locked = false;
+
+    uint64_t masterFrames;
+    int64_t masterTimeNs;
+    if (!ReadMaster(masterFrames, masterTimeNs) || timeNs - masterTimeNs > MASTER_STALE_NS) {
+        m_locked = false;
+        m_statLocked.store(false, std::memory_order_relaxed);
+        return 1.0;
+    }
+
+    double masterPosition = (double)masterFrames + (double)(timeNs - masterTimeNs) * 1e-9 * m_nominalRate;
+    double error = followerPosition - masterPosition;
+
+    // Lock onto whatever offset the two timelines have now; only its change is corrected
+    if (m_locked && std::abs(error - m_offset) > RELOCK_SECONDS * m_nominalRate) m_locked = false;
+    if (!m_locked) {
+        m_locked = true;
+        m_offset = error;
+        m_filtered = 0.0;
+        m_integral = 0.0;
+    }
+    error -= m_offset;
+
+    m_filtered += ERROR_FILTER * (error - m_filtered);
+    double dt = frameCount / m_nominalRate;
+    m_integral = std::clamp(m_integral + KI * m_filtered * dt, -MAX_CORRECTION, MAX_CORRECTION);
+    double correction = std::clamp(KP * m_filtered + m_integral, -MAX_CORRECTION, MAX_CORRECTION);
+
+    m_statLocked.store(true, std::memory_order_relaxed);
+    m_statDriftPpm.store(m_integral * 1e6, std::memory_order_relaxed);
+    m_statOffset.store(m_filtered, std::memory_order_relaxed);
+
+    // Follower ahead (positive error): consume content more slowly
+    return 1.0 - correction;
+}
+
+void DriftController::Reset() {
+    m_masterSeq.store(0, std::memory_order_release);
+    m_resetRequested.store(true, std::memory_order_release);
+    m_statLocked.store(false, std::memory_order_relaxed);
+}
+
+ClockStats DriftController::GetStats() const {
+    ClockStats stats;
+    stats.locked = m_statLocked.load(std::memory_order_relaxed);
+    stats.driftPpm = m_statDriftPpm.load(std::memory_order_relaxed);
+    stats.offsetFrames = m_statOffset.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct ClockStats {
+    bool locked = false;
+    double driftPpm = 0.0;      // How much faster the follower device's clock runs than the master's
+    double offsetFrames = 0.0;  // Filtered timeline error the controller is correcting
+};
+
+// Keeps a follower device's content timeline locked to a master device. The
+// master publishes its position each callback; the follower compares its own
+// position against the master's, extrapolated to the same instant, and a PI
+// loop turns the error into the resampling ratio for its next block. The
+// integral term settles on the clock drift between the two devices.
+class DriftController {
+public:
+    explicit DriftController(double nominalRate) : m_nominalRate(nominalRate) {}
+
+    // Master audio thread: content frames rendered before this block, and the callback time
+    void PublishMaster(uint64_t frames, int64_t timeNs);
+
+    // Follower audio thread: returns input frames per output frame for the block starting now
+    double Update(double followerPosition, int64_t timeNs, unsigned int frameCount);
+
+    // Call while both devices are stopped. The loop also unlocks by itself when the master goes quiet.
+    void Reset();
+    // Follower audio thread: its timeline jumped (e.g. it skipped buffered content), lock onto the new offset
+    void Relock() { m_locked = false; }
+    void SetNominalRate(double nominalRate) { m_nominalRate = nominalRate; } // Devices stopped, too
+    ClockStats GetStats() const;
+
+private:
+    bool ReadMaster(uint64_t& frames, int64_t& timeNs) const;
+
+    double m_nominalRate;
+
+    // Master snapshot behind a sequence counter (odd while being written)
+    std::atomic<uint32_t> m_masterSeq{ 0 };
+    std::atomic<uint64_t> m_masterFrames{ 0 };
+    std::atomic<int64_t> m_masterTimeNs{ 0 };
+
+    // Follower-side loop state
+    std::atomic<bool> m_resetRequested{ true };
+    bool m_locked = false;
+    double m_offset = 0.0;
+    double m_filtered = 0.0;
+    double m_integral = 0.0;
+
+    // Published for GetStats()
+    std::atomic<bool> m_statLocked{ false };
+    std::atomic<double> m_statDriftPpm{ 0.0 };
+    std::atomic<double> m_statOffset{ 0.0 };
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Engine settings the config also stores; plain enums, so including them pulls in no engine code
+
+// How decoded sounds are converted to the engine rate. Applied once, when a sound is
+// decoded into the cache; files already at the engine rate are never resampled.
+enum class DecodeQuality : uint8_t {
+    Linear,    // miniaudio's linear resampler inside the decoder (cheapest)
+    Sinc,      // Windowed sinc evaluated per output frame (reference quality, slowest)
+    Polyphase  // The same filter from precomputed phase tables: matches Sinc for common rate pairs at a fraction of the cost
+};
+
+// Which voice gives up its slot when a bus is at its voice limit
+enum class VoiceStealPolicy {
+    Oldest,    // Started longest ago
+    Quietest,  // Lowest recent output level
+    SameSound  // Oldest voice of the sound being triggered, else the oldest overall
+};
+
+// What triggering a sound does while earlier voices of it still play
+enum class RetriggerMode {
+    Overlap, // Start another voice alongside them
+    Toggle,  // Fade them out and start nothing (stop on re-press)
+    Restart  // Fade them out and start a new voice
+};
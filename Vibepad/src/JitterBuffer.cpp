@@ -0,0 +1,134 @@
+#include "JitterBuffer.h"
+
+#include <algorithm>
+
+static const double START_LEVEL_SECONDS = 0.02;  // Buffered before reading starts (and after an underrun)
+static const double MIN_MARGIN_SECONDS = 0.002;  // Headroom kept above the lowest observed need
+static const double MAX_MARGIN_SECONDS = 0.03;
+static const double MARGIN_STEP_SECONDS = 0.002; // Added per underrun
+static const double MARGIN_DECAY_SECONDS = 0.0001; // Given back per glitch-free window
+static const double WINDOW_SECONDS = 1.0;        // Fill minimum is tracked per window
+static const double KP = 1e-5;                   // Ratio change per frame of excess latency
+static const double KI = 2e-7;                   // Integral gain, per frame-second
+static const double MAX_DRIFT = 1e-3;            // 1000 ppm, far beyond real device drift
+static const double MAX_CORRECTION = 0.005;      // +-0.5% read rate, about 9 cents at most
+static const double FILL_SMOOTHING = 0.05;
+
+void JitterBuffer::Reset() {
+    m_writeSeq.store(0, std::memory_order_relaxed);
+    m_writeFrames.store(0, std::memory_order_relaxed);
+    m_writeTimeNs.store(0, std::memory_order_relaxed);
+    m_writeBlock.store(0, std::memory_order_relaxed);
+
+    m_readFrames = 0;
+    m_primed = false;
+    m_ratio = 1.0;
+    m_drift = 0.0;
+    m_margin = MIN_MARGIN_SECONDS * m_sampleRate;
+    m_smoothedFill = 0.0;
+    m_windowFrames = 0;
+    m_historyCount = 0;
+    m_historyNext = 0;
+    m_statRatio.store(1.0, std::memory_order_relaxed);
+    m_statDrift.store(0.0, std::memory_order_relaxed);
+}
+
+void JitterBuffer::OnWrite(unsigned int frames, int64_t timeNs) {
+    uint64_t total = m_writeFrames.load(std::memory_order_relaxed) + frames;
+    uint32_t seq = m_writeSeq.load(std::memory_order_relaxed);
+    m_writeSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_writeFrames.store(total, std::memory_order_relaxed);
+    m_writeTimeNs.store(timeNs, std::memory_order_relaxed);
+    m_writeBlock.store(frames, std::memory_order_relaxed);
+    m_writeSeq.store(seq + 2, std::memory_order_release);
+}
+
+bool JitterBuffer::ReadWriter(uint64_t& frames, int64_t& timeNs, unsigned int& blockFrames) const {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint32_t before = m_writeSeq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        frames = m_writeFrames.load(std::memory_order_relaxed);
+        timeNs = m_writeTimeNs.load(std::memory_order_relaxed);
+        blockFrames = m_writeBlock.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_writeSeq.load(std::memory_order_relaxed) == before) return before != 0;
+    }
+    return false;
+}
+
+bool JitterBuffer::Update(unsigned int frameCount, int64_t timeNs) {
+    uint64_t written;
+    int64_t writeTimeNs;
+    unsigned int block;
+    if (!ReadWriter(written, writeTimeNs, block)) return m_primed; // Nothing captured yet, or mid-write: keep the ratio
+
+    // Frames in the ring at the writer's last callback (the reader's own count is exact),
+    // plus what the device has captured since, up to one block
+    double fill = (double)(written - std::min(m_readFrames, written));
+    double pending = (double)(timeNs - writeTimeNs) * 1e-9 * m_sampleRate;
+    fill += std::clamp(pending, 0.0, (double)block);
+    m_fill = fill;
+
+    // Just before a capture block lands, the ring holds 'block' less than the virtual fill
+    double need = frameCount + block + m_margin;
+
+    if (!m_primed) {
+        if (fill < std::max(START_LEVEL_SECONDS * m_sampleRate, need)) return false;
+        m_primed = true;
+        m_smoothedFill = fill;
+        m_windowMin = fill;
+    }
+
+    // Fill minimum per window, kept for the last few windows
+    m_windowMin = std::min(m_windowMin, fill);
+    m_windowFrames += frameCount;
+    if (m_windowFrames >= WINDOW_SECONDS * m_sampleRate) {
+        m_history[m_historyNext] = m_windowMin;
+        m_historyNext = (m_historyNext + 1) % HISTORY_WINDOWS;
+        m_historyCount = std::min(m_historyCount + 1, HISTORY_WINDOWS);
+        m_windowMin = fill;
+        m_windowFrames = 0;
+        m_margin = std::max(m_margin - MARGIN_DECAY_SECONDS * m_sampleRate, MIN_MARGIN_SECONDS * m_sampleRate);
+    }
+
+    double lowest = m_windowMin;
+    for (int i = 0; i < m_historyCount; ++i) lowest = std::min(lowest, m_history[i]);
+
+    // Excess latency; negative means the buffer is running too close to empty
+    double excess = lowest - need;
+    m_drift = std::clamp(m_drift + KI * excess * (frameCount / m_sampleRate), -MAX_DRIFT, MAX_DRIFT);
+    m_ratio = 1.0 + std::clamp(m_drift + KP * excess, -MAX_CORRECTION, MAX_CORRECTION);
+
+    m_smoothedFill += FILL_SMOOTHING * (fill - m_smoothedFill);
+    m_statFill.store(m_smoothedFill / m_sampleRate * 1000.0, std::memory_order_relaxed);
+    m_statTarget.store(std::max(m_smoothedFill - excess, 0.0) / m_sampleRate * 1000.0, std::memory_order_relaxed);
+    m_statRatio.store(m_ratio, std::memory_order_relaxed);
+    m_statDrift.store(m_drift * 1e6, std::memory_order_relaxed);
+    return true;
+}
+
+void JitterBuffer::OnUnderrun() {
+    m_underruns.fetch_add(1, std::memory_order_relaxed);
+    // Refill before reading again and keep more headroom from now on; the margin
+    // shrinks back slowly while no further underruns happen
+    m_primed = false;
+    m_margin = std::min(m_margin + MARGIN_STEP_SECONDS * m_sampleRate, MAX_MARGIN_SECONDS * m_sampleRate);
+    m_windowFrames = 0;
+    m_historyCount = 0;
+}
+
+void JitterBuffer::OnOverrun() {
+    m_overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+JitterStats JitterBuffer::GetStats() const {
+    JitterStats stats;
+    stats.fillMs = m_statFill.load(std::memory_order_relaxed);
+    stats.targetMs = m_statTarget.load(std::memory_order_relaxed);
+    stats.ratio = m_statRatio.load(std::memory_order_relaxed);
+    stats.driftPpm = m_statDrift.load(std::memory_order_relaxed);
+    stats.underruns = m_underruns.load(std::memory_order_relaxed);
+    stats.overruns = m_overruns.load(std::memory_order_relaxed);
+    return stats;
+}
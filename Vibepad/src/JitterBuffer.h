@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct JitterStats {
+    double fillMs = 0.0;       // Smoothed buffered audio, including the part of the current capture block still in the device
+    double targetMs = 0.0;     // Estimated minimum safe latency the buffer converges to
+    double ratio = 1.0;        // Current read rate (input frames per output frame)
+    double driftPpm = 0.0;     // Learned clock drift: how much faster the writer's device runs than the reader's
+    uint64_t underruns = 0;    // Reader found too little data
+    uint64_t overruns = 0;     // Writer found the ring full and dropped input
+};
+
+// Latency controller for a ring buffer between two device clocks (the mic
+// passthrough). The ring's fill jumps by a whole capture block whenever the
+// writer runs, and where the reader lands between those jumps slides slowly
+// with clock drift, so the reader measures a "virtual" fill instead: what the
+// ring holds plus what the capture device has collected since its last block.
+// The lowest virtual fill over the last few seconds shows how much buffering
+// callback jitter actually needs. Anything above that plus a small margin is
+// excess latency, which is drained (or, when short, rebuilt) by reading
+// slightly faster or slower instead of dropping audio. A PI loop drives the
+// excess to zero: its integral term settles on the drift between the two
+// device clocks, so latency stays put over hours instead of sagging.
+class JitterBuffer {
+public:
+    explicit JitterBuffer(double sampleRate) : m_sampleRate(sampleRate) {}
+
+    // Call while neither side is running, together with emptying the ring
+    void Reset();
+    void SetSampleRate(double sampleRate) { m_sampleRate = sampleRate; }
+
+    // Writer thread, after each block: frames actually stored in the ring, and the callback time
+    void OnWrite(unsigned int frames, int64_t timeNs);
+
+    // Reader thread, once per block before reading. Returns false while the buffer
+    // is (re)filling to its start level; the reader should then output silence.
+    bool Update(unsigned int frameCount, int64_t timeNs);
+
+    // Reader thread: input frames to consume per output frame for this block
+    double GetRatio() const { return m_ratio; }
+    // Reader thread: virtual fill in frames seen by the last Update
+    double GetFill() const { return m_fill; }
+
+    // Reader thread: frames taken from the ring, and blocks that could not be fully served
+    void OnRead(size_t frames) { m_readFrames += frames; }
+    void OnUnderrun();
+
+    // Writer thread: incoming frames dropped because the ring was full
+    void OnOverrun();
+
+    JitterStats GetStats() const;
+
+private:
+    static constexpr int HISTORY_WINDOWS = 8;
+
+    bool ReadWriter(uint64_t& frames, int64_t& timeNs, unsigned int& blockFrames) const;
+
+    double m_sampleRate;
+
+    // Writer snapshot behind a sequence counter (odd while being written)
+    std::atomic<uint32_t> m_writeSeq{ 0 };
+    std::atomic<uint64_t> m_writeFrames{ 0 };
+    std::atomic<int64_t> m_writeTimeNs{ 0 };
+    std::atomic<unsigned int> m_writeBlock{ 0 };
+
+    // Reader-side state
+    uint64_t m_readFrames = 0;
+    bool m_primed = false;
+    double m_ratio = 1.0;
+    double m_fill = 0.0;
+    double m_drift = 0.0;   // Integral term, survives underruns
+    double m_margin = 0.0;  // Frames of headroom; grows on underruns, decays back
+    double m_smoothedFill = 0.0;
+    double m_windowMin = 0.0;
+    unsigned int m_windowFrames = 0;
+    double m_history[HISTORY_WINDOWS] = {};
+    int m_historyCount = 0;
+    int m_historyNext = 0;
+
+    // Published for GetStats()
+    std::atomic<double> m_statFill{ 0.0 };
+    std::atomic<double> m_statTarget{ 0.0 };
+    std::atomic<double> m_statRatio{ 1.0 };
+    std::atomic<double> m_statDrift{ 0.0 };
+    std::atomic<uint64_t> m_underruns{ 0 };
+    std::atomic<uint64_t> m_overruns{ 0 };
+};
@@ -0,0 +1,201 @@
+#include "LatencyMonitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+// Rows wait at most this long before reaching the file
+static const std::chrono::milliseconds LOG_INTERVAL(100);
+static const int64_t MIC_ROW_INTERVAL_NS = 1000000000;
+
+static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// -----------------------------------------------------------------------------
+// HISTOGRAM
+// -----------------------------------------------------------------------------
+int LatencyHistogram::BucketOf(uint64_t us) {
+    const uint64_t sub = 1ull << SUB_BITS;
+    if (us < sub * 2) return (int)us;
+    int msb = 0;
+    for (uint64_t v = us; v > 1; v >>= 1) ++msb;
+    if (msb >= MAX_BITS) return BUCKETS - 1;
+    int shift = msb - SUB_BITS;
+    return ((shift + 1) << SUB_BITS) + (int)((us >> shift) - sub);
+}
+
+double LatencyHistogram::BucketMidUs(int bucket) {
+    const int sub = 1 << SUB_BITS;
+    if (bucket < sub * 2) return bucket + 0.5;
+    int shift = (bucket >> SUB_BITS) - 1;
+    double lower = (double)((uint64_t)(sub + (bucket & (sub - 1))) << shift);
+    return lower + (double)(1ull << shift) * 0.5;
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+    ns = std::max<int64_t>(ns, 0);
+    m_buckets[BucketOf((uint64_t)ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+
+    int64_t prev = m_maxNs.load(std::memory_order_relaxed);
+    while (ns > prev && !m_maxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+}
+
+LatencyPercentiles LatencyHistogram::Snapshot() const {
+    uint32_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    LatencyPercentiles result;
+    result.count = total;
+    if (total == 0) return result;
+
+    // Smallest bucket whose cumulative count reaches the rank
+    uint64_t rank50 = (total * 50 + 99) / 100;
+    uint64_t rank99 = (total * 99 + 99) / 100;
+    uint64_t seen = 0;
+    bool have50 = false;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (!have50 && seen >= rank50) {
+            result.p50Ms = BucketMidUs(i) / 1000.0;
+            have50 = true;
+        }
+        if (seen >= rank99) {
+            result.p99Ms = BucketMidUs(i) / 1000.0;
+            break;
+        }
+    }
+
+    // The exact maximum also caps the bucket estimates
+    result.maxMs = m_maxNs.load(std::memory_order_relaxed) / 1e6;
+    result.p50Ms = std::min(result.p50Ms, result.maxMs);
+    result.p99Ms = std::min(result.p99Ms, result.maxMs);
+    return result;
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// MONITOR
+// -----------------------------------------------------------------------------
+LatencyMonitor::~LatencyMonitor() {
+    StopLog();
+}
+
+void LatencyMonitor::RecordTrigger(const TriggerTiming& timing) {
+    m_decoded.Record(timing.readyNs > timing.triggerNs ? timing.readyNs - timing.triggerNs : 0);
+    m_voice.Record(timing.voiceStartNs - timing.triggerNs);
+    m_firstBlock.Record(timing.firstBlockNs - timing.triggerNs);
+
+    LogRow row;
+    row.trigger = timing;
+    row.timeNs = timing.triggerNs;
+    Push(row);
+}
+
+void LatencyMonitor::RecordMicBuffer(double seconds, int64_t nowNs) {
+    m_mic.Record((int64_t)(seconds * 1e9));
+
+    if (nowNs - m_lastMicRowNs < MIC_ROW_INTERVAL_NS) return;
+    m_lastMicRowNs = nowNs;
+    LogRow row;
+    row.mic = true;
+    row.timeNs = nowNs;
+    row.micMs = seconds * 1000.0;
+    Push(row);
+}
+
+void LatencyMonitor::Push(const LogRow& row) {
+    if (!m_logging.load(std::memory_order_relaxed)) return;
+    if (!m_rows.Push(row)) m_logDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyReport LatencyMonitor::GetReport() const {
+    LatencyReport report;
+    report.triggerToDecoded = m_decoded.Snapshot();
+    report.triggerToVoice = m_voice.Snapshot();
+    report.triggerToFirstBlock = m_firstBlock.Snapshot();
+    report.micBuffer = m_mic.Snapshot();
+    report.logDropped = m_logDropped.load(std::memory_order_relaxed);
+    return report;
+}
+
+void LatencyMonitor::Reset() {
+    m_decoded.Reset();
+    m_voice.Reset();
+    m_firstBlock.Reset();
+    m_mic.Reset();
+    m_logDropped.store(0, std::memory_order_relaxed);
+}
+
+bool LatencyMonitor::StartLog(const std::filesystem::path& path) {
+    StopLog();
+
+    m_log.open(path, std::ios::out | std::ios::trunc);
+    if (!m_log.is_open()) return false;
+    m_log << "event,time_ms,decoded_ms,voice_ms,first_block_ms,mic_buffer_ms\n";
+    m_log << std::fixed << std::setprecision(3);
+
+    // Rows queued after a previous log stopped are stale
+    LogRow stale;
+    while (m_rows.Pop(stale)) {}
+
+    m_logStartNs = NowNs();
+    m_stopping = false;
+    m_thread = std::thread(&LatencyMonitor::ThreadLoop, this);
+    m_logging.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void LatencyMonitor::StopLog() {
+    m_logging.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+
+    if (m_log.is_open()) {
+        WriteRows();
+        m_log.close();
+    }
+}
+
+void LatencyMonitor::WriteRows() {
+    LogRow row;
+    bool wrote = false;
+    while (m_rows.Pop(row)) {
+        double timeMs = (row.timeNs - m_logStartNs) / 1e6;
+        if (row.mic) {
+            m_log << "mic," << timeMs << ",,,," << row.micMs << '\n';
+        }
+        else {
+            const TriggerTiming& t = row.trigger;
+            double decodedMs = t.readyNs > t.triggerNs ? (t.readyNs - t.triggerNs) / 1e6 : 0.0;
+            m_log << "trigger," << timeMs << ',' << decodedMs << ','
+                << (t.voiceStartNs - t.triggerNs) / 1e6 << ','
+                << (t.firstBlockNs - t.triggerNs) / 1e6 << ",\n";
+        }
+        wrote = true;
+    }
+    if (wrote) m_log.flush();
+}
+
+void LatencyMonitor::ThreadLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, LOG_INTERVAL, [this] { return m_stopping; });
+            if (m_stopping) return;
+        }
+        WriteRows();
+    }
+}
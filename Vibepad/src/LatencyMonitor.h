@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "SpscQueue.h"
+
+struct LatencyPercentiles {
+    uint64_t count = 0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+struct LatencyReport {
+    LatencyPercentiles triggerToDecoded;    // PlaySoundFile -> first samples readable (0 when cached)
+    LatencyPercentiles triggerToVoice;      // PlaySoundFile -> voice started by the cable callback
+    LatencyPercentiles triggerToFirstBlock; // PlaySoundFile -> first cable block containing the sound
+    LatencyPercentiles micBuffer;           // Audio buffered on the mic path, sampled every cable block
+    uint64_t logDropped = 0;                // CSV rows lost because the log thread fell behind
+};
+
+// Steady-clock timestamps of one trigger, in nanoseconds
+struct TriggerTiming {
+    int64_t triggerNs = 0;
+    int64_t readyNs = 0;      // 0 if the data was ready before the trigger
+    int64_t voiceStartNs = 0;
+    int64_t firstBlockNs = 0;
+};
+
+// Log-linear histogram of durations: 16 buckets per octave of microseconds,
+// so percentiles are within about 3%. Recording is a couple of relaxed atomic
+// increments, safe on the audio threads; snapshots may tear slightly while
+// samples are still coming in.
+class LatencyHistogram {
+public:
+    void Record(int64_t ns);
+    LatencyPercentiles Snapshot() const;
+    void Reset();
+
+private:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int MAX_BITS = 36;  // ~19 hours of microseconds; longer values are clamped
+    static constexpr int BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+
+    static int BucketOf(uint64_t us);
+    static double BucketMidUs(int bucket);
+
+    std::atomic<uint32_t> m_buckets[BUCKETS] = {};
+    std::atomic<int64_t> m_maxNs{ 0 };
+};
+
+// Timing of the trigger-to-audio path and the mic passthrough. The cable audio
+// thread records; any thread may read a report. Optionally every trigger (and
+// the mic buffer once per second) is also written as a CSV row by a background
+// thread, so file I/O never touches the audio path.
+class LatencyMonitor {
+public:
+    LatencyMonitor() = default;
+    ~LatencyMonitor();
+
+    // Cable audio thread
+    void RecordTrigger(const TriggerTiming& timing);
+    void RecordMicBuffer(double seconds, int64_t nowNs);
+
+    LatencyReport GetReport() const;
+    void Reset();
+
+    // Columns: event, time_ms (since the log started), decoded_ms, voice_ms, first_block_ms, mic_buffer_ms
+    bool StartLog(const std::filesystem::path& path);
+    void StopLog();
+
+private:
+    struct LogRow {
+        bool mic = false;
+        TriggerTiming trigger;
+        int64_t timeNs = 0;
+        double micMs = 0.0;
+    };
+
+    void Push(const LogRow& row);
+    void ThreadLoop();
+    void WriteRows();
+
+    LatencyHistogram m_decoded;
+    LatencyHistogram m_voice;
+    LatencyHistogram m_firstBlock;
+    LatencyHistogram m_mic;
+    int64_t m_lastMicRowNs = 0; // Cable audio thread
+
+    SpscQueue<LogRow, 1024> m_rows;
+    std::atomic<bool> m_logging{ false };
+    std::atomic<uint64_t> m_logDropped{ 0 };
+    std::ofstream m_log;
+    int64_t m_logStartNs = 0;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+};
@@ -0,0 +1,153 @@
+#include "Limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Long enough for the gain to ramp down smoothly ahead of a transient, short enough not to be heard as delay
+const float LOOKAHEAD_SECONDS = 0.0015f;
+// Scratch size; longer blocks are processed in pieces
+const size_t CHUNK_FRAMES = 1024;
+// Rounding in the gain math never reaches the soft clipper
+const float CLIP_TOLERANCE = 1.0001f;
+// The release ends once it is this close to its target (far below audibility)
+const float RELEASE_SNAP = 1e-6f;
+
+static float DbToGain(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+static double GainToDb(float gain) {
+    return gain > 0.0f ? 20.0 * std::log10((double)gain) : -120.0;
+}
+
+void Limiter::Init(unsigned int channels, unsigned int sampleRate) {
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+    m_lookahead = std::max<size_t>(2, (size_t)(sampleRate * LOOKAHEAD_SECONDS));
+
+    m_peaks.assign(CHUNK_FRAMES, 0.0f);
+    m_gains.assign(CHUNK_FRAMES, 1.0f);
+    m_work.assign((m_lookahead - 1 + CHUNK_FRAMES) * channels, 0.0f);
+    m_holdValue.assign(m_lookahead, 1.0f);
+    m_holdFrame.assign(m_lookahead, 0);
+    m_box.assign(m_lookahead, 1.0f);
+    Reset();
+}
+
+void Limiter::Reset() {
+    std::fill(m_work.begin(), m_work.end(), 0.0f);
+    std::fill(m_box.begin(), m_box.end(), 1.0f);
+    m_holdHead = 0;
+    m_holdCount = 0;
+    m_boxPos = 0;
+    m_boxSum = (double)m_lookahead;
+    m_envelope = 1.0f;
+    m_frame = 0;
+}
+
+void Limiter::SetCeiling(float ceilingDb) { m_ceilingDb = std::min(ceilingDb, 0.0f); }
+void Limiter::SetRelease(float releaseMs) { m_releaseMs = std::max(releaseMs, 1.0f); }
+
+void Limiter::Process(float* pBuffer, unsigned int frameCount) {
+    float ceiling = DbToGain(m_ceilingDb.load(std::memory_order_relaxed));
+    float releaseSeconds = m_releaseMs.load(std::memory_order_relaxed) * 0.001f;
+    float releaseCoef = 1.0f - std::exp(-1.0f / (releaseSeconds * (float)m_sampleRate));
+
+    float blockMin = 1.0f;
+    for (size_t done = 0; done < frameCount; ) {
+        size_t n = std::min<size_t>(frameCount - done, CHUNK_FRAMES);
+        ProcessChunk(pBuffer + done * m_channels, n, ceiling, releaseCoef);
+        for (size_t i = 0; i < n; ++i) blockMin = std::min(blockMin, m_gains[i]);
+        done += n;
+    }
+
+    m_lastMinGain.store(blockMin, std::memory_order_relaxed);
+    if (blockMin < m_windowMinGain.load(std::memory_order_relaxed)) m_windowMinGain.store(blockMin, std::memory_order_relaxed);
+}
+
+void Limiter::ProcessChunk(float* pBuffer, size_t frames, float ceiling, float releaseCoef) {
+    const size_t ch = m_channels;
+    const size_t delay = m_lookahead - 1;
+
+    // 1. Frame peaks
+    for (size_t i = 0; i < frames; ++i) {
+        float peak = 0.0f;
+        for (size_t c = 0; c < ch; ++c) peak = std::max(peak, std::fabs(pBuffer[i * ch + c]));
+        m_peaks[i] = peak;
+    }
+
+    // 2. Gain: the lowest gain any frame in the look-ahead window needs, released
+    // exponentially, then averaged over the window. The average reaches a frame's
+    // required gain exactly when that frame leaves the delay line.
+    uint64_t limited = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        float required = m_peaks[i] > ceiling ? ceiling / m_peaks[i] : 1.0f;
+
+        // Monotonic queue: drop the frame leaving the window, then every entry the new one undercuts
+        if (m_holdCount > 0 && m_holdFrame[m_holdHead] + m_lookahead <= m_frame) {
+            m_holdHead = m_holdHead + 1 == m_lookahead ? 0 : m_holdHead + 1;
+            --m_holdCount;
+        }
+        while (m_holdCount > 0) {
+            size_t back = m_holdHead + m_holdCount - 1;
+            if (back >= m_lookahead) back -= m_lookahead;
+            if (m_holdValue[back] < required) break;
+            --m_holdCount;
+        }
+        size_t slot = m_holdHead + m_holdCount;
+        if (slot >= m_lookahead) slot -= m_lookahead;
+        m_holdValue[slot] = required;
+        m_holdFrame[slot] = m_frame;
+        ++m_holdCount;
+        float held = m_holdValue[m_holdHead];
+        ++m_frame;
+
+        m_envelope = held < m_envelope ? held : m_envelope + (held - m_envelope) * releaseCoef;
+        if (held - m_envelope < RELEASE_SNAP) m_envelope = held; // Otherwise float rounding stalls it just below 1
+
+        m_boxSum += (double)m_envelope - (double)m_box[m_boxPos];
+        m_box[m_boxPos] = m_envelope;
+        m_boxPos = m_boxPos + 1 == m_lookahead ? 0 : m_boxPos + 1;
+
+        float gain = std::min(1.0f, (float)(m_boxSum / (double)m_lookahead));
+        m_gains[i] = gain;
+        limited += gain < 1.0f;
+    }
+
+    // 3. Delay line: the output is the input from 'delay' frames ago, times the gain
+    float* pWork = m_work.data();
+    memcpy(pWork + delay * ch, pBuffer, frames * ch * sizeof(float));
+    for (size_t i = 0; i < frames; ++i) {
+        float gain = m_gains[i];
+        for (size_t c = 0; c < ch; ++c) pBuffer[i * ch + c] = pWork[i * ch + c] * gain;
+    }
+    memmove(pWork, pWork + frames * ch, delay * ch * sizeof(float));
+
+    // 4. Soft clipper above the ceiling, bending into the headroom left below 0 dBFS
+    float knee = ceiling * CLIP_TOLERANCE;
+    float headroom = 1.0f - knee;
+    uint64_t clipped = 0;
+    for (size_t i = 0; i < frames * ch; ++i) {
+        float x = pBuffer[i];
+        float magnitude = std::fabs(x);
+        if (magnitude <= knee) continue;
+        float bent = headroom > 1e-6f ? knee + headroom * std::tanh((magnitude - knee) / headroom) : 1.0f;
+        pBuffer[i] = std::copysign(bent, x);
+        ++clipped;
+    }
+
+    if (limited) m_limitedFrames.fetch_add(limited, std::memory_order_relaxed);
+    if (clipped) m_clippedSamples.fetch_add(clipped, std::memory_order_relaxed);
+}
+
+LimiterStats Limiter::GetStats(bool resetWindow) {
+    LimiterStats stats;
+    stats.limitedFrames = m_limitedFrames.load(std::memory_order_relaxed);
+    stats.clippedSamples = m_clippedSamples.load(std::memory_order_relaxed);
+    stats.gainReductionDb = -GainToDb(m_lastMinGain.load(std::memory_order_relaxed));
+    float windowMin = resetWindow ? m_windowMinGain.exchange(1.0f, std::memory_order_relaxed)
+        : m_windowMinGain.load(std::memory_order_relaxed);
+    stats.peakReductionDb = -GainToDb(windowMin);
+    return stats;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct LimiterStats {
+    uint64_t limitedFrames = 0;  // Frames output with any gain reduction
+    uint64_t clippedSamples = 0; // Samples the soft clipper had to bend (the limiter missed them)
+
+    double gainReductionDb = 0.0; // Deepest reduction in the most recent block
+    double peakReductionDb = 0.0; // Deepest reduction since the previous GetStats(true)
+};
+
+// Look-ahead peak limiter for an output bus, followed by a soft clipper as a
+// safety net. The signal is delayed by the look-ahead window, so the gain can
+// ramp down before a peak arrives and no sample leaves above the ceiling; the
+// gain then recovers with an exponential release.
+//
+// Each block runs as separate passes over contiguous arrays (frame peaks, gain
+// envelope, gain multiply), so the first and last vectorize. Init allocates
+// everything; Process never does.
+class Limiter {
+public:
+    // While the audio thread isn't running
+    void Init(unsigned int channels, unsigned int sampleRate);
+    void Reset();
+
+    // Any thread; picked up at the next block
+    void SetCeiling(float ceilingDb);
+    void SetRelease(float releaseMs);
+
+    // Audio thread: limits pBuffer (interleaved) in place
+    void Process(float* pBuffer, unsigned int frameCount);
+
+    LimiterStats GetStats(bool resetWindow);
+
+    // Frames of delay the look-ahead adds
+    size_t GetLatencyFrames() const { return m_lookahead - 1; }
+
+private:
+    void ProcessChunk(float* pBuffer, size_t frames, float ceiling, float releaseCoef);
+
+    unsigned int m_channels = 2;
+    unsigned int m_sampleRate = 48000;
+    size_t m_lookahead = 1; // Window of the minimum hold and of the attack ramp, in frames
+
+    std::atomic<float> m_ceilingDb{ -1.0f };
+    std::atomic<float> m_releaseMs{ 100.0f };
+
+    // Audio thread state, sized in Init
+    std::vector<float> m_peaks;   // Per-frame peak of the current chunk
+    std::vector<float> m_gains;   // Per-frame gain of the current chunk
+    std::vector<float> m_work;    // Delayed frames followed by the current chunk
+    std::vector<float> m_holdValue; // Monotonic queue of the window's required gains
+    std::vector<uint64_t> m_holdFrame;
+    size_t m_holdHead = 0;
+    size_t m_holdCount = 0;
+    std::vector<float> m_box;     // Last m_lookahead envelope values, averaged into the gain
+    size_t m_boxPos = 0;
+    double m_boxSum = 0.0;
+    float m_envelope = 1.0f;
+    uint64_t m_frame = 0;
+
+    std::atomic<uint64_t> m_limitedFrames{ 0 };
+    std::atomic<uint64_t> m_clippedSamples{ 0 };
+    std::atomic<float> m_lastMinGain{ 1.0f };
+    std::atomic<float> m_windowMinGain{ 1.0f };
+};
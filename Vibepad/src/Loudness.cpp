@@ -0,0 +1,114 @@
+#include "Loudness.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const double PI = 3.14159265358979323846;
+
+// Steps per gating block (400 ms in 100 ms steps)
+const size_t BLOCK_STEPS = 4;
+const double RELATIVE_GATE_LU = -10.0;
+
+static double ToLufs(double meanSquare) {
+    return -0.691 + 10.0 * std::log10(meanSquare);
+}
+
+// The K-weighting filters are specified at 48 kHz; these are their analog prototypes
+// bilinear-transformed for any rate (the same derivation libebur128 uses)
+LoudnessMeter::LoudnessMeter(unsigned int channels, unsigned int sampleRate)
+    : m_channels(channels), m_state(channels * 2) {
+    const double fs = (double)sampleRate;
+
+    double f0 = 1681.974450955533;
+    double gainDb = 3.999843853973347;
+    double q = 0.7071752369554196;
+    double k = std::tan(PI * f0 / fs);
+    double vh = std::pow(10.0, gainDb / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+    m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+    m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+    m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+    m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+    m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = std::tan(PI * f0 / fs);
+    a0 = 1.0 + k / q + k * k;
+    m_highpass.b0 = 1.0;
+    m_highpass.b1 = -2.0;
+    m_highpass.b2 = 1.0;
+    m_highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+    m_highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+    m_stepFrames = std::max<size_t>(1, (size_t)std::lround(fs * 0.1));
+}
+
+void LoudnessMeter::AddFrames(const float* pFrames, size_t frameCount) {
+    const size_t ch = m_channels;
+    for (size_t i = 0; i < frameCount; ++i) {
+        double frameSum = 0.0;
+        for (size_t c = 0; c < ch; ++c) {
+            // Transposed direct form II, shelf then high-pass
+            double x = pFrames[i * ch + c];
+            BiquadState& s1 = m_state[c * 2];
+            double y = m_shelf.b0 * x + s1.z1;
+            s1.z1 = m_shelf.b1 * x - m_shelf.a1 * y + s1.z2;
+            s1.z2 = m_shelf.b2 * x - m_shelf.a2 * y;
+
+            BiquadState& s2 = m_state[c * 2 + 1];
+            double z = m_highpass.b0 * y + s2.z1;
+            s2.z1 = m_highpass.b1 * y - m_highpass.a1 * z + s2.z2;
+            s2.z2 = m_highpass.b2 * y - m_highpass.a2 * z;
+
+            frameSum += z * z;
+        }
+
+        m_stepSum += frameSum;
+        m_totalSum += frameSum;
+        ++m_totalFrames;
+        if (++m_stepFill == m_stepFrames) {
+            m_steps.push_back(m_stepSum / (double)m_stepFrames);
+            m_stepSum = 0.0;
+            m_stepFill = 0;
+        }
+    }
+}
+
+double LoudnessMeter::GetIntegratedLufs() const {
+    if (m_steps.size() < BLOCK_STEPS) {
+        if (m_totalFrames == 0 || m_totalSum <= 0.0) return SILENCE_LUFS;
+        return std::max(ToLufs(m_totalSum / (double)m_totalFrames), SILENCE_LUFS);
+    }
+
+    // Mean square of every 400 ms block, advancing 100 ms at a time
+    std::vector<double> blocks;
+    blocks.reserve(m_steps.size() - BLOCK_STEPS + 1);
+    double absoluteSum = 0.0;
+    size_t absoluteCount = 0;
+    for (size_t i = 0; i + BLOCK_STEPS <= m_steps.size(); ++i) {
+        double z = 0.0;
+        for (size_t j = 0; j < BLOCK_STEPS; ++j) z += m_steps[i + j];
+        z /= (double)BLOCK_STEPS;
+        blocks.push_back(z);
+        if (z > 0.0 && ToLufs(z) > SILENCE_LUFS) {
+            absoluteSum += z;
+            ++absoluteCount;
+        }
+    }
+    if (absoluteCount == 0) return SILENCE_LUFS;
+
+    double relativeGate = ToLufs(absoluteSum / (double)absoluteCount) + RELATIVE_GATE_LU;
+    double gatedSum = 0.0;
+    size_t gatedCount = 0;
+    for (double z : blocks) {
+        if (z <= 0.0) continue;
+        double lufs = ToLufs(z);
+        if (lufs > SILENCE_LUFS && lufs > relativeGate) {
+            gatedSum += z;
+            ++gatedCount;
+        }
+    }
+    return gatedCount > 0 ? ToLufs(gatedSum / (double)gatedCount) : SILENCE_LUFS;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Integrated loudness after ITU-R BS.1770-4 / EBU R128, in LUFS: K-weighted mean
+// square over 400 ms blocks (75% overlap), gated at -70 LUFS and then 10 LU
+// below the ungated level. Fed a whole file in chunks, it keeps one value per
+// 100 ms, so memory stays small for long sounds. Every channel has weight 1,
+// which is exact for mono and stereo (the only layouts the engine plays).
+class LoudnessMeter {
+public:
+    // Loudness reported for silence and for sounds too quiet to pass the absolute gate
+    static constexpr double SILENCE_LUFS = -70.0;
+
+    LoudnessMeter(unsigned int channels, unsigned int sampleRate);
+
+    // Interleaved f32 frames
+    void AddFrames(const float* pFrames, size_t frameCount);
+
+    // Sounds shorter than one 400 ms block are measured as a single block
+    double GetIntegratedLufs() const;
+
+private:
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+    struct BiquadState {
+        double z1 = 0.0, z2 = 0.0;
+    };
+
+    unsigned int m_channels;
+    Biquad m_shelf;    // Stage 1: head-related high shelf
+    Biquad m_highpass; // Stage 2: RLB high-pass
+    std::vector<BiquadState> m_state; // Two per channel
+
+    size_t m_stepFrames;      // 100 ms
+    size_t m_stepFill = 0;    // Frames summed into m_stepSum so far
+    double m_stepSum = 0.0;   // Weighted sum of squares of the current 100 ms step
+    std::vector<double> m_steps; // Mean square of each completed step
+
+    // Everything seen, for sounds shorter than one block
+    double m_totalSum = 0.0;
+    size_t m_totalFrames = 0;
+};
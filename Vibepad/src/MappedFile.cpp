@@ -0,0 +1,92 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Smallest page size on the supported platforms; one read per page faults each one in
+const size_t PAGE_BYTES = 4096;
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+#ifdef _WIN32
+    // FILE_SHARE_DELETE so removing a sound or a cache entry still works while it is mapped
+    HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(hFile);
+    if (!hMapping) return false;
+
+    // The view keeps the mapping alive, so both handles can be closed right away
+    m_pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping);
+    if (!m_pData) return false;
+
+    m_size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    m_pData = p;
+    m_size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!m_pData) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_pData);
+#else
+    munmap(m_pData, m_size);
+#endif
+    m_pData = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::Warm(const void* pFrom, size_t bytes) const {
+    if (!m_pData) return;
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = { m_pData, m_size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(m_pData, m_size, MADV_WILLNEED);
+#endif
+
+    const uint8_t* p = (const uint8_t*)pFrom;
+    const uint8_t* pEnd = std::min(p + bytes, (const uint8_t*)m_pData + m_size);
+    volatile uint8_t sink = 0; // Keeps the reads from being optimized out
+    for (; p < pEnd; p += PAGE_BYTES) sink = sink ^ *p;
+}
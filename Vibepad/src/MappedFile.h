@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file. Pages come straight from the OS
+// file cache, so mapped data costs no private heap and is shared between users.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    const void* Data() const { return m_pData; }
+    size_t Size() const { return m_size; }
+
+    // Asks the OS to read the whole file in ahead of use, then faults in 'bytes' from
+    // pFrom (inside the view) on the calling thread, so a reader that must not block
+    // finds at least that part resident
+    void Warm(const void* pFrom, size_t bytes) const;
+
+private:
+    void* m_pData = nullptr;
+    size_t m_size = 0;
+};
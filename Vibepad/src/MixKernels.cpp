@@ -0,0 +1,445 @@
+#include "MixKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VIBEPAD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts AVX intrinsics anywhere; GCC/Clang need the function tagged
+#if defined(VIBEPAD_X86) && !defined(_MSC_VER)
+#define VIBEPAD_TARGET_SSE2 __attribute__((target("sse2")))
+#define VIBEPAD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VIBEPAD_TARGET_SSE2
+#define VIBEPAD_TARGET_AVX2
+#endif
+
+namespace MixKernels {
+
+    // -----------------------------------------------------------------------------
+    // CPU FEATURE DETECTION
+    // -----------------------------------------------------------------------------
+    bool HasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+        return true; // Part of the x64 baseline
+#elif defined(VIBEPAD_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#elif defined(VIBEPAD_X86)
+        return __builtin_cpu_supports("sse2");
+#else
+        return false;
+#endif
+    }
+
+    bool HasAvx2() {
+#if defined(VIBEPAD_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        // The OS must save YMM state on context switches
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(VIBEPAD_X86)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    // -----------------------------------------------------------------------------
+    // IMPLEMENTATIONS
+    // -----------------------------------------------------------------------------
+    void MixAddScalar(float* dst, const float* src, size_t count, float gain) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] += src[i] * gain;
+        }
+    }
+
+    // Even samples (left) are scaled by gainL, odd ones (right) by gainR
+    void MixAddStereoScalar(float* dst, const float* src, size_t count, float gainL, float gainR) {
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            dst[i] += src[i] * gainL;
+            dst[i + 1] += src[i + 1] * gainR;
+        }
+        if (i < count) dst[i] += src[i] * gainL;
+    }
+
+#ifdef VIBEPAD_X86
+    // The SIMD loops below take the gains as a vector. Every step is a multiple of two
+    // samples, so an alternating L/R vector stays on the right channels.
+    VIBEPAD_TARGET_SSE2
+    static size_t MixAddLanesSse2(float* dst, const float* src, size_t count, const __m128& g) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128 a = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+            __m128 b = _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+            _mm_storeu_ps(dst + i, a);
+            _mm_storeu_ps(dst + i + 4, b);
+        }
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+        }
+        return i;
+    }
+
+    // mul + add rather than FMA so every kernel rounds exactly like the scalar one
+    VIBEPAD_TARGET_AVX2
+    static size_t MixAddLanesAvx2(float* dst, const float* src, size_t count, const __m256& g) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256 a = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+            __m256 b = _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), g));
+            _mm256_storeu_ps(dst + i, a);
+            _mm256_storeu_ps(dst + i + 8, b);
+        }
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+        }
+        return i;
+    }
+#endif
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddSse2(float* dst, const float* src, size_t count, float gain) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddLanesSse2(dst, src, count, _mm_set1_ps(gain));
+        MixAddScalar(dst + i, src + i, count - i, gain);
+#else
+        MixAddScalar(dst, src, count, gain);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddAvx2(float* dst, const float* src, size_t count, float gain) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddLanesAvx2(dst, src, count, _mm256_set1_ps(gain));
+        MixAddScalar(dst + i, src + i, count - i, gain);
+#else
+        MixAddScalar(dst, src, count, gain);
+#endif
+    }
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddStereoSse2(float* dst, const float* src, size_t count, float gainL, float gainR) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddLanesSse2(dst, src, count, _mm_setr_ps(gainL, gainR, gainL, gainR));
+        MixAddStereoScalar(dst + i, src + i, count - i, gainL, gainR);
+#else
+        MixAddStereoScalar(dst, src, count, gainL, gainR);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddStereoAvx2(float* dst, const float* src, size_t count, float gainL, float gainR) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddLanesAvx2(dst, src, count, _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR));
+        MixAddStereoScalar(dst + i, src + i, count - i, gainL, gainR);
+#else
+        MixAddStereoScalar(dst, src, count, gainL, gainR);
+#endif
+    }
+
+    // The s16 kernels fold the 1/32768 normalization into the gain. int16 -> float
+    // is exact, so every variant again rounds exactly like the scalar one.
+    void MixAddS16Scalar(float* dst, const int16_t* src, size_t count, float gain) {
+        const float scale = gain * (1.0f / 32768.0f);
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] += (float)src[i] * scale;
+        }
+    }
+
+    void MixAddS16StereoScalar(float* dst, const int16_t* src, size_t count, float gainL, float gainR) {
+        const float scaleL = gainL * (1.0f / 32768.0f);
+        const float scaleR = gainR * (1.0f / 32768.0f);
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            dst[i] += (float)src[i] * scaleL;
+            dst[i + 1] += (float)src[i + 1] * scaleR;
+        }
+        if (i < count) dst[i] += (float)src[i] * scaleL;
+    }
+
+#ifdef VIBEPAD_X86
+    // 'g' already includes the 1/32768 normalization
+    VIBEPAD_TARGET_SSE2
+    static size_t MixAddS16LanesSse2(float* dst, const int16_t* src, size_t count, const __m128& g) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // Sign-extend by placing each sample in the high half of a 32-bit lane and shifting back
+            __m128i raw = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16));
+            __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16));
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(lo, g)));
+            _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(hi, g)));
+        }
+        return i;
+    }
+
+    VIBEPAD_TARGET_AVX2
+    static size_t MixAddS16LanesAvx2(float* dst, const int16_t* src, size_t count, const __m256& g) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+            __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8))));
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(a, g)));
+            _mm256_storeu_ps(dst + i + 8, _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_mul_ps(b, g)));
+        }
+        for (; i + 8 <= count; i += 8) {
+            __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(a, g)));
+        }
+        return i;
+    }
+#endif
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddS16Sse2(float* dst, const int16_t* src, size_t count, float gain) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddS16LanesSse2(dst, src, count, _mm_set1_ps(gain * (1.0f / 32768.0f)));
+        MixAddS16Scalar(dst + i, src + i, count - i, gain);
+#else
+        MixAddS16Scalar(dst, src, count, gain);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddS16Avx2(float* dst, const int16_t* src, size_t count, float gain) {
+#ifdef VIBEPAD_X86
+        size_t i = MixAddS16LanesAvx2(dst, src, count, _mm256_set1_ps(gain * (1.0f / 32768.0f)));
+        MixAddS16Scalar(dst + i, src + i, count - i, gain);
+#else
+        MixAddS16Scalar(dst, src, count, gain);
+#endif
+    }
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddS16StereoSse2(float* dst, const int16_t* src, size_t count, float gainL, float gainR) {
+#ifdef VIBEPAD_X86
+        const float l = gainL * (1.0f / 32768.0f), r = gainR * (1.0f / 32768.0f);
+        size_t i = MixAddS16LanesSse2(dst, src, count, _mm_setr_ps(l, r, l, r));
+        MixAddS16StereoScalar(dst + i, src + i, count - i, gainL, gainR);
+#else
+        MixAddS16StereoScalar(dst, src, count, gainL, gainR);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddS16StereoAvx2(float* dst, const int16_t* src, size_t count, float gainL, float gainR) {
+#ifdef VIBEPAD_X86
+        const float l = gainL * (1.0f / 32768.0f), r = gainR * (1.0f / 32768.0f);
+        size_t i = MixAddS16LanesAvx2(dst, src, count, _mm256_setr_ps(l, r, l, r, l, r, l, r));
+        MixAddS16StereoScalar(dst + i, src + i, count - i, gainL, gainR);
+#else
+        MixAddS16StereoScalar(dst, src, count, gainL, gainR);
+#endif
+    }
+
+    // -----------------------------------------------------------------------------
+    // RAMPED GAIN
+    // -----------------------------------------------------------------------------
+    // Sample i belongs to frame i / channels and gets gainStart[c] + gainStep[c] * frame.
+    // The SIMD variants compute the same expression per lane (frame numbers are exact in
+    // float), so they again round exactly like the scalar loop.
+    static void MixAddRampTail(float* dst, const float* src, size_t begin, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+        for (size_t i = begin; i < count; ++i) {
+            size_t c = i % channels;
+            dst[i] += src[i] * (gainStart[c] + gainStep[c] * (float)(i / channels));
+        }
+    }
+
+    static void MixAddS16RampTail(float* dst, const int16_t* src, size_t begin, size_t count, unsigned int channels, const float* scaledStart, const float* scaledStep) {
+        for (size_t i = begin; i < count; ++i) {
+            size_t c = i % channels;
+            dst[i] += (float)src[i] * (scaledStart[c] + scaledStep[c] * (float)(i / channels));
+        }
+    }
+
+    void MixAddRampScalar(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+        MixAddRampTail(dst, src, 0, count, channels, gainStart, gainStep);
+    }
+
+    void MixAddS16RampScalar(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+        float scaledStart[2], scaledStep[2];
+        for (unsigned int c = 0; c < channels; ++c) {
+            scaledStart[c] = gainStart[c] * (1.0f / 32768.0f);
+            scaledStep[c] = gainStep[c] * (1.0f / 32768.0f);
+        }
+        MixAddS16RampTail(dst, src, 0, count, channels, scaledStart, scaledStep);
+    }
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddRampSse2(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+#ifdef VIBEPAD_X86
+        // Lane j is sample j of a group: channel j % channels of frame (group start) + lane[j]
+        const bool stereo = channels == 2;
+        const __m128 g0 = stereo ? _mm_setr_ps(gainStart[0], gainStart[1], gainStart[0], gainStart[1]) : _mm_set1_ps(gainStart[0]);
+        const __m128 dg = stereo ? _mm_setr_ps(gainStep[0], gainStep[1], gainStep[0], gainStep[1]) : _mm_set1_ps(gainStep[0]);
+        const __m128 lane = stereo ? _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f) : _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 frame = _mm_add_ps(_mm_set1_ps((float)(i / channels)), lane);
+            __m128 g = _mm_add_ps(g0, _mm_mul_ps(dg, frame));
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+        }
+        MixAddRampTail(dst, src, i, count, channels, gainStart, gainStep);
+#else
+        MixAddRampScalar(dst, src, count, channels, gainStart, gainStep);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddRampAvx2(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+#ifdef VIBEPAD_X86
+        const bool stereo = channels == 2;
+        const float l0 = gainStart[0], r0 = stereo ? gainStart[1] : gainStart[0];
+        const float ld = gainStep[0], rd = stereo ? gainStep[1] : gainStep[0];
+        const __m256 g0 = _mm256_setr_ps(l0, r0, l0, r0, l0, r0, l0, r0);
+        const __m256 dg = _mm256_setr_ps(ld, rd, ld, rd, ld, rd, ld, rd);
+        const __m256 lane = stereo ? _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f)
+            : _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 frame = _mm256_add_ps(_mm256_set1_ps((float)(i / channels)), lane);
+            __m256 g = _mm256_add_ps(g0, _mm256_mul_ps(dg, frame));
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+        }
+        MixAddRampTail(dst, src, i, count, channels, gainStart, gainStep);
+#else
+        MixAddRampScalar(dst, src, count, channels, gainStart, gainStep);
+#endif
+    }
+
+    VIBEPAD_TARGET_SSE2
+    void MixAddS16RampSse2(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+#ifdef VIBEPAD_X86
+        const bool stereo = channels == 2;
+        const float k = 1.0f / 32768.0f;
+        const float scaledStart[2] = { gainStart[0] * k, (stereo ? gainStart[1] : gainStart[0]) * k };
+        const float scaledStep[2] = { gainStep[0] * k, (stereo ? gainStep[1] : gainStep[0]) * k };
+        const __m128 g0 = _mm_setr_ps(scaledStart[0], scaledStart[1], scaledStart[0], scaledStart[1]);
+        const __m128 dg = _mm_setr_ps(scaledStep[0], scaledStep[1], scaledStep[0], scaledStep[1]);
+        const __m128 laneLo = stereo ? _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f) : _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 laneHi = _mm_add_ps(laneLo, _mm_set1_ps(stereo ? 2.0f : 4.0f));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i raw = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16));
+            __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16));
+            __m128 frame = _mm_set1_ps((float)(i / channels));
+            __m128 gLo = _mm_add_ps(g0, _mm_mul_ps(dg, _mm_add_ps(frame, laneLo)));
+            __m128 gHi = _mm_add_ps(g0, _mm_mul_ps(dg, _mm_add_ps(frame, laneHi)));
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(lo, gLo)));
+            _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(hi, gHi)));
+        }
+        MixAddS16RampTail(dst, src, i, count, channels, scaledStart, scaledStep);
+#else
+        MixAddS16RampScalar(dst, src, count, channels, gainStart, gainStep);
+#endif
+    }
+
+    VIBEPAD_TARGET_AVX2
+    void MixAddS16RampAvx2(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+#ifdef VIBEPAD_X86
+        const bool stereo = channels == 2;
+        const float k = 1.0f / 32768.0f;
+        const float scaledStart[2] = { gainStart[0] * k, (stereo ? gainStart[1] : gainStart[0]) * k };
+        const float scaledStep[2] = { gainStep[0] * k, (stereo ? gainStep[1] : gainStep[0]) * k };
+        const float l0 = scaledStart[0], r0 = scaledStart[1], ld = scaledStep[0], rd = scaledStep[1];
+        const __m256 g0 = _mm256_setr_ps(l0, r0, l0, r0, l0, r0, l0, r0);
+        const __m256 dg = _mm256_setr_ps(ld, rd, ld, rd, ld, rd, ld, rd);
+        const __m256 lane = stereo ? _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f)
+            : _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+            __m256 frame = _mm256_add_ps(_mm256_set1_ps((float)(i / channels)), lane);
+            __m256 g = _mm256_add_ps(g0, _mm256_mul_ps(dg, frame));
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(a, g)));
+        }
+        MixAddS16RampTail(dst, src, i, count, channels, scaledStart, scaledStep);
+#else
+        MixAddS16RampScalar(dst, src, count, channels, gainStart, gainStep);
+#endif
+    }
+
+    // -----------------------------------------------------------------------------
+    // DISPATCH
+    // -----------------------------------------------------------------------------
+    using MixAddFn = void(*)(float*, const float*, size_t, float);
+    using MixAddS16Fn = void(*)(float*, const int16_t*, size_t, float);
+    using MixAddStereoFn = void(*)(float*, const float*, size_t, float, float);
+    using MixAddS16StereoFn = void(*)(float*, const int16_t*, size_t, float, float);
+    using MixAddRampFn = void(*)(float*, const float*, size_t, unsigned int, const float*, const float*);
+    using MixAddS16RampFn = void(*)(float*, const int16_t*, size_t, unsigned int, const float*, const float*);
+
+    struct Dispatch {
+        MixAddFn mixAdd = MixAddScalar;
+        MixAddS16Fn mixAddS16 = MixAddS16Scalar;
+        MixAddStereoFn mixAddStereo = MixAddStereoScalar;
+        MixAddS16StereoFn mixAddS16Stereo = MixAddS16StereoScalar;
+        MixAddRampFn mixAddRamp = MixAddRampScalar;
+        MixAddS16RampFn mixAddS16Ramp = MixAddS16RampScalar;
+        const char* name = "Scalar";
+
+        Dispatch() {
+            if (HasAvx2()) {
+                mixAdd = MixAddAvx2; mixAddS16 = MixAddS16Avx2;
+                mixAddStereo = MixAddStereoAvx2; mixAddS16Stereo = MixAddS16StereoAvx2;
+                mixAddRamp = MixAddRampAvx2; mixAddS16Ramp = MixAddS16RampAvx2;
+                name = "AVX2";
+            }
+            else if (HasSse2()) {
+                mixAdd = MixAddSse2; mixAddS16 = MixAddS16Sse2;
+                mixAddStereo = MixAddStereoSse2; mixAddS16Stereo = MixAddS16StereoSse2;
+                mixAddRamp = MixAddRampSse2; mixAddS16Ramp = MixAddS16RampSse2;
+                name = "SSE2";
+            }
+        }
+    };
+
+    static const Dispatch& GetDispatch() {
+        static const Dispatch dispatch; // Resolved once, before the first audio callback uses it
+        return dispatch;
+    }
+
+    void MixAdd(float* dst, const float* src, size_t count, float gain) {
+        GetDispatch().mixAdd(dst, src, count, gain);
+    }
+
+    void MixAddS16(float* dst, const int16_t* src, size_t count, float gain) {
+        GetDispatch().mixAddS16(dst, src, count, gain);
+    }
+
+    void MixAddStereo(float* dst, const float* src, size_t count, float gainL, float gainR) {
+        GetDispatch().mixAddStereo(dst, src, count, gainL, gainR);
+    }
+
+    void MixAddS16Stereo(float* dst, const int16_t* src, size_t count, float gainL, float gainR) {
+        GetDispatch().mixAddS16Stereo(dst, src, count, gainL, gainR);
+    }
+
+    void MixAddRamp(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+        GetDispatch().mixAddRamp(dst, src, count, channels, gainStart, gainStep);
+    }
+
+    void MixAddS16Ramp(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep) {
+        GetDispatch().mixAddS16Ramp(dst, src, count, channels, gainStart, gainStep);
+    }
+
+    const char* GetActiveKernelName() {
+        return GetDispatch().name;
+    }
+}
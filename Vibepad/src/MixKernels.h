@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorized inner loops of the mixer. The public entry points pick the widest
+// instruction set the CPU supports (AVX2 > SSE2 > scalar) on first use.
+namespace MixKernels {
+
+    // dst[i] += src[i] * gain
+    void MixAdd(float* dst, const float* src, size_t count, float gain);
+
+    // dst[i] += src[i] / 32768 * gain, widening compact s16 storage on the fly
+    void MixAddS16(float* dst, const int16_t* src, size_t count, float gain);
+
+    // Interleaved stereo with a gain per channel (pan); 'count' is in samples, starting on a left one
+    void MixAddStereo(float* dst, const float* src, size_t count, float gainL, float gainR);
+    void MixAddS16Stereo(float* dst, const int16_t* src, size_t count, float gainL, float gainR);
+
+    // Per-frame gain ramp: sample i (channel c, frame f = i / channels) is scaled by
+    // gainStart[c] + gainStep[c] * f. 'channels' is 1 or 2 and 'count' (in samples)
+    // a whole number of frames.
+    void MixAddRamp(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddS16Ramp(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+
+    const char* GetActiveKernelName();
+
+    // Individual implementations, exposed for benchmarking. Only call the SIMD
+    // variants when the matching Has*() check returns true.
+    void MixAddScalar(float* dst, const float* src, size_t count, float gain);
+    void MixAddSse2(float* dst, const float* src, size_t count, float gain);
+    void MixAddAvx2(float* dst, const float* src, size_t count, float gain);
+    void MixAddS16Scalar(float* dst, const int16_t* src, size_t count, float gain);
+    void MixAddS16Sse2(float* dst, const int16_t* src, size_t count, float gain);
+    void MixAddS16Avx2(float* dst, const int16_t* src, size_t count, float gain);
+    void MixAddStereoScalar(float* dst, const float* src, size_t count, float gainL, float gainR);
+    void MixAddStereoSse2(float* dst, const float* src, size_t count, float gainL, float gainR);
+    void MixAddStereoAvx2(float* dst, const float* src, size_t count, float gainL, float gainR);
+    void MixAddS16StereoScalar(float* dst, const int16_t* src, size_t count, float gainL, float gainR);
+    void MixAddS16StereoSse2(float* dst, const int16_t* src, size_t count, float gainL, float gainR);
+    void MixAddS16StereoAvx2(float* dst, const int16_t* src, size_t count, float gainL, float gainR);
+    void MixAddRampScalar(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddRampSse2(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddRampAvx2(float* dst, const float* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddS16RampScalar(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddS16RampSse2(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+    void MixAddS16RampAvx2(float* dst, const int16_t* src, size_t count, unsigned int channels, const float* gainStart, const float* gainStep);
+
+    bool HasSse2();
+    bool HasAvx2();
+}
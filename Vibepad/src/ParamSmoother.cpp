@@ -0,0 +1,47 @@
+#include "ParamSmoother.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The exponential ramp time spans this many time constants (e^-5 = 0.7%)
+const float EXP_RAMP_CONSTANTS = 5.0f;
+// An exponential glide ends once it is this close to the target (below audibility at unit gain)
+const float EXP_SNAP = 1e-5f;
+
+void ParamSmoother::Init(unsigned int sampleRate, float rampMs, RampShape shape) {
+    m_shape = shape;
+    m_rampFrames = std::max(1.0f, rampMs * (float)sampleRate / 1000.0f);
+    m_timeConstant = m_rampFrames / EXP_RAMP_CONSTANTS;
+    m_framesLeft = m_value != m_target ? m_rampFrames : 0.0f;
+}
+
+void ParamSmoother::SetTarget(float target) {
+    if (target == m_target) return;
+    m_target = target;
+    m_framesLeft = m_rampFrames;
+}
+
+void ParamSmoother::Reset(float value) {
+    m_value = value;
+    m_target = value;
+    m_framesLeft = 0.0f;
+}
+
+float ParamSmoother::Advance(unsigned int frames) {
+    if (m_value == m_target) return m_value;
+
+    if (m_shape == RampShape::Linear) {
+        // The remaining distance over the remaining frames, so the ramp ends exactly on time
+        if ((float)frames >= m_framesLeft) {
+            m_value = m_target;
+            m_framesLeft = 0.0f;
+        } else {
+            m_value += (m_target - m_value) * ((float)frames / m_framesLeft);
+            m_framesLeft -= (float)frames;
+        }
+    } else {
+        m_value = m_target + (m_value - m_target) * std::exp(-(float)frames / m_timeConstant);
+        if (std::fabs(m_target - m_value) < EXP_SNAP) m_value = m_target;
+    }
+    return m_value;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+enum class RampShape : uint8_t {
+    Linear,     // Constant rate: reaches the target exactly after the ramp time
+    Exponential // One-pole: fast at first, within 0.7% of the target after the ramp time
+};
+
+// Glides a gain toward its target instead of stepping at a block boundary, which
+// clicks. The audio thread advances it once per block and applies the block's
+// start and end values as a per-frame linear ramp (see MixKernels::MixAddRamp),
+// so an exponential glide is piecewise linear at block resolution. Plain state,
+// no allocation; Init and the setters may run on the audio thread.
+class ParamSmoother {
+public:
+    void Init(unsigned int sampleRate, float rampMs, RampShape shape);
+
+    // A new target restarts the ramp from the current value; the same target is a no-op
+    void SetTarget(float target);
+    // Jumps straight to 'value' (nothing audible yet, or a fresh voice)
+    void Reset(float value);
+
+    float GetValue() const { return m_value; } // At the first frame of the next block
+    float GetTarget() const { return m_target; }
+    bool IsRamping() const { return m_value != m_target; }
+
+    // Moves one block of 'frames' ahead and returns the new value. Frame i of the
+    // block gets start + (end - start) * i / frames, with start = GetValue() before the call.
+    float Advance(unsigned int frames);
+
+private:
+    float m_value = 1.0f;
+    float m_target = 1.0f;
+    float m_framesLeft = 0.0f;   // Linear: until the target is reached
+    float m_rampFrames = 1.0f;
+    float m_timeConstant = 1.0f; // Exponential, in frames
+    RampShape m_shape = RampShape::Linear;
+};
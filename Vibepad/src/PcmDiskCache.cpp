@@ -0,0 +1,150 @@
+#include "PcmDiskCache.h"
+
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// -----------------------------------------------------------------------------
+// FILE FORMAT
+// -----------------------------------------------------------------------------
+static const char CACHE_MAGIC[4] = { 'V', 'P', 'C', 'M' };
+static const uint32_t CACHE_VERSION = 2;
+static const uint32_t CACHE_FORMAT_F32 = 1;
+static const uint32_t CACHE_FORMAT_S16 = 2;
+
+static uint32_t FormatTag(SampleFormat format) {
+    return format == SampleFormat::S16 ? CACHE_FORMAT_S16 : CACHE_FORMAT_F32;
+}
+
+// 64 bytes, so the samples that follow stay 16-byte aligned inside the mapping
+struct PcmCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t channels;
+    uint32_t sampleRate;
+    uint32_t quality; // DecodeQuality the PCM was resampled with
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sampleCount;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(PcmCacheHeader) == 64, "PcmCacheHeader must stay 64 bytes");
+
+static bool GetSourceStamp(const fs::path& sourcePath, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = fs::file_size(sourcePath, ec);
+    if (ec) return false;
+    auto writeTime = fs::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    mtime = (int64_t)writeTime.time_since_epoch().count();
+    return true;
+}
+
+// Shared by every entry of one source: FNV-1a over the path
+std::wstring PcmDiskCache::EntryPrefix(const std::wstring& sourcePath) {
+    uint64_t hash = 1469598103934665603ull;
+    for (wchar_t c : sourcePath) {
+        hash ^= (uint64_t)c;
+        hash *= 1099511628211ull;
+    }
+
+    wchar_t prefix[32];
+    swprintf(prefix, 32, L"%016llx-", (unsigned long long)hash);
+    return prefix;
+}
+
+fs::path PcmDiskCache::EntryPath(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+    SampleFormat format, DecodeQuality quality) {
+    wchar_t name[64];
+    swprintf(name, 64, L"%u-%u-%ls-q%u.pcm", sampleRate, channels,
+        format == SampleFormat::S16 ? L"s16" : L"f32", (unsigned int)quality);
+    return fs::path(sourcePath).parent_path() / L".cache" / (EntryPrefix(sourcePath) + name);
+}
+
+// -----------------------------------------------------------------------------
+// LOAD / STORE
+// -----------------------------------------------------------------------------
+std::unique_ptr<MappedFile> PcmDiskCache::Load(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+    SampleFormat format, DecodeQuality quality, const void** ppSamples, size_t* pSampleCount) {
+    if (!m_enabled) return nullptr;
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!GetSourceStamp(sourcePath, sourceSize, sourceMtime)) return nullptr;
+
+    auto file = std::make_unique<MappedFile>();
+    if (!file->Open(EntryPath(sourcePath, channels, sampleRate, format, quality))) return nullptr;
+    if (file->Size() < sizeof(PcmCacheHeader)) return nullptr;
+
+    PcmCacheHeader header;
+    memcpy(&header, file->Data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION) return nullptr;
+    if (header.format != FormatTag(format) || header.channels != channels || header.sampleRate != sampleRate) return nullptr;
+    if (header.quality != (uint32_t)quality) return nullptr;
+
+    // Stale: the source was replaced or edited since this entry was written
+    if (header.sourceSize != sourceSize || header.sourceMtime != sourceMtime) return nullptr;
+
+    if (header.sampleCount == 0 || file->Size() - sizeof(PcmCacheHeader) != header.sampleCount * SampleFormatSize(format)) return nullptr;
+
+    *ppSamples = (const char*)file->Data() + sizeof(PcmCacheHeader);
+    *pSampleCount = (size_t)header.sampleCount;
+    return file;
+}
+
+bool PcmDiskCache::Store(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+    SampleFormat format, DecodeQuality quality, const void* pSamples, size_t sampleCount) {
+    if (!m_enabled || sampleCount == 0) return false;
+
+    PcmCacheHeader header = {};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.format = FormatTag(format);
+    header.channels = channels;
+    header.sampleRate = sampleRate;
+    header.quality = (uint32_t)quality;
+    header.sampleCount = sampleCount;
+    if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceMtime)) return false;
+
+    fs::path target = EntryPath(sourcePath, channels, sampleRate, format, quality);
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+
+    // Write under a temporary name and rename, so a crash never leaves a truncated entry behind
+    fs::path temp = target;
+    temp += L".tmp" + std::to_wstring(m_tempCounter++);
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)pSamples, (std::streamsize)(sampleCount * SampleFormatSize(format)));
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+void PcmDiskCache::Remove(const std::wstring& sourcePath) {
+    std::error_code ec;
+    fs::path dir = fs::path(sourcePath).parent_path() / L".cache";
+    std::wstring prefix = EntryPrefix(sourcePath);
+
+    std::vector<fs::path> stale;
+    for (fs::directory_iterator it(dir, ec), last; !ec && it != last; it.increment(ec)) {
+        if (it->path().filename().wstring().compare(0, prefix.size(), prefix) == 0) stale.push_back(it->path());
+    }
+    for (const auto& path : stale) fs::remove(path, ec);
+}
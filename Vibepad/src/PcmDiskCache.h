@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <filesystem>
+
+#include "MappedFile.h"
+#include "SampleFormat.h"
+#include "EngineOptions.h"
+
+// Persistent decoded-PCM cache kept beside the sound files (sounds/.cache).
+// Each entry is raw f32 or s16 samples behind a small header, named after the
+// source path, engine format and decode quality, and stamped with the source's size + mtime. Entries are memory-mapped
+// on load, so a cached sound starts instantly and its pages live in the OS file cache.
+class PcmDiskCache {
+public:
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    // Maps the cached PCM for 'sourcePath' if it is present, current and in the requested format
+    std::unique_ptr<MappedFile> Load(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+        SampleFormat format, DecodeQuality quality, const void** ppSamples, size_t* pSampleCount);
+
+    bool Store(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+        SampleFormat format, DecodeQuality quality, const void* pSamples, size_t sampleCount);
+
+    // Drops the entries of every format and quality
+    void Remove(const std::wstring& sourcePath);
+
+private:
+    static std::wstring EntryPrefix(const std::wstring& sourcePath);
+    static std::filesystem::path EntryPath(const std::wstring& sourcePath, unsigned int channels, unsigned int sampleRate,
+        SampleFormat format, DecodeQuality quality);
+
+    std::atomic<bool> m_enabled{ true };
+    std::atomic<unsigned int> m_tempCounter{ 0 };
+};
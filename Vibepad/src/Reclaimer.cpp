@@ -0,0 +1,53 @@
+#include "Reclaimer.h"
+
+#include <chrono>
+
+// Retired sounds wait at most this long; nothing is time-critical on this side
+static const std::chrono::milliseconds RECLAIM_INTERVAL(20);
+
+Reclaimer::~Reclaimer() {
+    Stop();
+}
+
+void Reclaimer::Start() {
+    Stop();
+    m_stopping = false;
+    m_thread = std::thread(&Reclaimer::ThreadLoop, this);
+}
+
+void Reclaimer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+
+    // Producers are stopped by now; release whatever they left behind
+    Drain();
+}
+
+void Reclaimer::Retire(int lane, std::shared_ptr<AudioData>&& data) {
+    if (!data) return;
+    if (!m_lanes[lane].Push(std::move(data))) {
+        m_overflows.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Reclaimer::Drain() {
+    std::shared_ptr<AudioData> data;
+    for (auto& lane : m_lanes) {
+        while (lane.Pop(data)) data.reset();
+    }
+}
+
+void Reclaimer::ThreadLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, RECLAIM_INTERVAL, [this] { return m_stopping; });
+            if (m_stopping) return;
+        }
+        Drain();
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+#include "SpscQueue.h"
+
+struct AudioData;
+
+// Takes finished sounds off the audio threads. Dropping the last reference to an
+// AudioData frees its buffers or closes its decoder, so the callbacks hand
+// retired references over here and a background thread lets go of them.
+class Reclaimer {
+public:
+    static const int LANE_COUNT = 1;           // One per mix bus, fed by whichever callback mixes it
+    static const size_t LANE_CAPACITY = 1024;
+
+    Reclaimer() = default;
+    ~Reclaimer();
+
+    void Start();
+    void Stop();
+
+    // Real-time safe. If the lane is full the reference is dropped in place and counted.
+    void Retire(int lane, std::shared_ptr<AudioData>&& data);
+
+    uint64_t GetOverflowCount() const { return m_overflows.load(std::memory_order_relaxed); }
+
+private:
+    void ThreadLoop();
+    void Drain();
+
+    SpscQueue<std::shared_ptr<AudioData>, LANE_CAPACITY> m_lanes[LANE_COUNT];
+    std::atomic<uint64_t> m_overflows{ 0 };
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+};
@@ -0,0 +1,59 @@
+#include "RtCheck.h"
+
+#ifdef VIBEPAD_RT_CHECK
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+static thread_local int t_realtimeDepth = 0;
+static std::atomic<uint64_t> s_violations{ 0 };
+
+namespace RtCheck {
+    void EnterRealtime() { ++t_realtimeDepth; }
+    void LeaveRealtime() { --t_realtimeDepth; }
+    uint64_t GetViolationCount() { return s_violations.load(std::memory_order_relaxed); }
+}
+
+static void CheckHeapUse() {
+    if (t_realtimeDepth > 0) {
+        s_violations.fetch_add(1, std::memory_order_relaxed);
+        assert(!"Heap allocation or free on an audio thread");
+    }
+}
+
+// -----------------------------------------------------------------------------
+// GLOBAL OPERATOR NEW / DELETE
+// -----------------------------------------------------------------------------
+// The nothrow forms forward to these in the standard library.
+void* operator new(std::size_t size) {
+    CheckHeapUse();
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    CheckHeapUse();
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+#endif
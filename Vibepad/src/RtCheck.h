@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Debug detector for heap traffic on the audio threads. Building with
+// VIBEPAD_RT_CHECK defined replaces the global operator new/delete: every
+// allocation or free made while a Scope is alive on the calling thread is
+// counted and, in builds with assertions, asserts. Otherwise Scope is free.
+namespace RtCheck {
+
+#ifdef VIBEPAD_RT_CHECK
+    void EnterRealtime();
+    void LeaveRealtime();
+    uint64_t GetViolationCount();
+#else
+    inline void EnterRealtime() {}
+    inline void LeaveRealtime() {}
+    inline uint64_t GetViolationCount() { return 0; }
+#endif
+
+    // Marks the calling thread as real-time for the scope's lifetime
+    struct Scope {
+        Scope() { EnterRealtime(); }
+        ~Scope() { LeaveRealtime(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
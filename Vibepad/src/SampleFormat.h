@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Storage format of decoded sound data. The mix itself always runs in f32;
+// S16 halves cache memory and per-voice bandwidth and is widened in the mixer.
+enum class SampleFormat : uint8_t {
+    F32,
+    S16
+};
+
+inline size_t SampleFormatSize(SampleFormat format) {
+    return format == SampleFormat::S16 ? sizeof(int16_t) : sizeof(float);
+}
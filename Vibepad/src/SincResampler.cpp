@@ -0,0 +1,157 @@
+#include "SincResampler.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+// Zero crossings on each side of the kernel at unity ratio; widened by the ratio when downsampling
+const double HALF_TAPS = 32.0;
+// Kaiser shape: about -90 dB stopband with this length
+const double KAISER_BETA = 9.0;
+// Passband as a share of the lower Nyquist frequency; the transition band sits above it
+const double ROLLOFF = 0.95;
+// Ratios with more phases than this (after reduction) interpolate between table rows
+const uint64_t MAX_TABLE_PHASES = 1024;
+
+static const double PI = 3.14159265358979323846;
+
+// Modified Bessel function of the first kind, order 0
+static double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double half = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= half / k;
+        double sq = term * term;
+        sum += sq;
+        if (sq < sum * 1e-15) break;
+    }
+    return sum;
+}
+
+void SincResampler::Init(unsigned int inRate, unsigned int outRate, unsigned int channels, DecodeQuality quality) {
+    m_channels = channels;
+    m_quality = quality;
+
+    uint64_t g = std::gcd((uint64_t)inRate, (uint64_t)outRate);
+    m_phases = outRate / g;
+    m_step = inRate / g;
+
+    double scale = std::min(1.0, (double)outRate / inRate);
+    m_cutoff = 0.5 * scale * ROLLOFF;
+    m_halfWidth = HALF_TAPS / scale;
+    size_t reach = (size_t)std::ceil(m_halfWidth);
+    m_taps = reach * 2;
+    m_lead = reach - 1;
+
+    m_table.clear();
+    m_tableRows = 0;
+    m_exactTable = false;
+    if (quality != DecodeQuality::Polyphase) return;
+
+    m_exactTable = m_phases <= MAX_TABLE_PHASES;
+    // The interpolated table has one extra row for frac = 1, so the last interval has a right neighbour
+    m_tableRows = m_exactTable ? (size_t)m_phases : (size_t)MAX_TABLE_PHASES + 1;
+    m_table.resize(m_tableRows * m_taps);
+    double denominator = m_exactTable ? (double)m_phases : (double)MAX_TABLE_PHASES;
+    for (size_t row = 0; row < m_tableRows; ++row) {
+        ComputeTaps(row / denominator, m_table.data() + row * m_taps);
+    }
+}
+
+size_t SincResampler::OutputFrames(size_t inFrames) const {
+    return (size_t)(((uint64_t)inFrames * m_phases + m_step - 1) / m_step);
+}
+
+size_t SincResampler::OutputFramesReady(size_t inFrames) const {
+    // The last tap of frame j reads input floor(j * step / phases) - lead + taps - 1
+    if (inFrames + m_lead < m_taps) return 0;
+    uint64_t limit = (uint64_t)(inFrames + m_lead - m_taps) + 1; // Exclusive bound on floor(j * step / phases)
+    size_t ready = (size_t)((limit * m_phases + m_step - 1) / m_step);
+    return std::min(ready, OutputFrames(inFrames));
+}
+
+// Taps for an output frame 'frac' input frames to the right of an input frame. Tap m
+// weights the input frame m - lead to the right of it. Normalized to unity DC gain.
+void SincResampler::ComputeTaps(double frac, float* pTaps) const {
+    const double norm = 1.0 / BesselI0(KAISER_BETA);
+    double sum = 0.0;
+    for (size_t m = 0; m < m_taps; ++m) {
+        double d = frac + (double)m_lead - (double)m;
+        double w = d / m_halfWidth;
+        double value = 0.0;
+        if (w > -1.0 && w < 1.0) {
+            double x = 2.0 * m_cutoff * d;
+            double sinc = x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+            value = 2.0 * m_cutoff * sinc * BesselI0(KAISER_BETA * std::sqrt(1.0 - w * w)) * norm;
+        }
+        pTaps[m] = (float)value;
+        sum += value;
+    }
+    float gain = sum != 0.0 ? (float)(1.0 / sum) : 0.0f;
+    for (size_t m = 0; m < m_taps; ++m) pTaps[m] *= gain;
+}
+
+void SincResampler::InterpolateTaps(uint64_t phase, float* pTaps) const {
+    double pos = (double)phase * MAX_TABLE_PHASES / (double)m_phases;
+    size_t row = std::min((size_t)pos, (size_t)MAX_TABLE_PHASES - 1);
+    float t = (float)(pos - (double)row);
+    const float* a = m_table.data() + row * m_taps;
+    const float* b = a + m_taps;
+    for (size_t m = 0; m < m_taps; ++m) pTaps[m] = a[m] + (b[m] - a[m]) * t;
+}
+
+static inline void StoreSample(float* pDst, float value) {
+    *pDst = value;
+}
+
+static inline void StoreSample(int16_t* pDst, float value) {
+    value = std::clamp(value, -1.0f, 1.0f) * 32767.0f;
+    *pDst = (int16_t)std::lrintf(value);
+}
+
+template <typename T>
+void SincResampler::ProcessRange(const float* pIn, size_t inFrames, T* pOut, size_t begin, size_t end) const {
+    const size_t ch = m_channels;
+    std::vector<float> scratch(m_taps);
+
+    for (size_t j = begin; j < end; ++j) {
+        uint64_t position = (uint64_t)j * m_step;
+        uint64_t base = position / m_phases;
+        uint64_t phase = position % m_phases;
+
+        const float* pTaps;
+        if (m_quality == DecodeQuality::Polyphase && m_exactTable) {
+            pTaps = m_table.data() + phase * m_taps;
+        }
+        else {
+            if (m_quality == DecodeQuality::Polyphase) InterpolateTaps(phase, scratch.data());
+            else ComputeTaps((double)phase / (double)m_phases, scratch.data());
+            pTaps = scratch.data();
+        }
+
+        // Taps that fall before the start or past the decoded input read silence
+        int64_t first = (int64_t)base - (int64_t)m_lead;
+        size_t m0 = first < 0 ? (size_t)(-first) : 0;
+        size_t m1 = m_taps;
+        if (first + (int64_t)m_taps > (int64_t)inFrames) {
+            m1 = (int64_t)inFrames > first ? (size_t)((int64_t)inFrames - first) : 0;
+        }
+
+        T* pDst = pOut + j * ch;
+        for (size_t c = 0; c < ch; ++c) {
+            float acc = 0.0f;
+            if (m0 < m1) {
+                const float* pSrc = pIn + (size_t)(first + (int64_t)m0) * ch + c;
+                for (size_t m = m0; m < m1; ++m, pSrc += ch) acc += *pSrc * pTaps[m];
+            }
+            StoreSample(pDst + c, acc);
+        }
+    }
+}
+
+void SincResampler::Process(const float* pIn, size_t inFrames, void* pOut, SampleFormat format, size_t begin, size_t end) const {
+    if (end <= begin) return;
+    if (format == SampleFormat::S16) ProcessRange(pIn, inFrames, (int16_t*)pOut, begin, end);
+    else ProcessRange(pIn, inFrames, (float*)pOut, begin, end);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "EngineOptions.h"
+#include "SampleFormat.h"
+
+// Offline band-limited resampler for whole decoded sounds. Each output frame is a
+// Kaiser-windowed sinc over the input around its exact rational position, so any
+// output range can be rendered on its own once the input under it is decoded.
+class SincResampler {
+public:
+    // quality must be Sinc or Polyphase. Builds the phase tables, so call it off the audio threads.
+    void Init(unsigned int inRate, unsigned int outRate, unsigned int channels, DecodeQuality quality);
+
+    // Output frames for a whole input of 'inFrames' frames
+    size_t OutputFrames(size_t inFrames) const;
+    // Output frames [0, n) whose taps all fall inside the first 'inFrames' input frames
+    size_t OutputFramesReady(size_t inFrames) const;
+
+    // Renders output frames [begin, end) into pOut, which holds the whole output (frame 0
+    // first). Input frames at or past inFrames read as silence. Runs on the calling thread:
+    // decodes already run on pool workers, which is where the parallelism comes from.
+    void Process(const float* pIn, size_t inFrames, void* pOut, SampleFormat format, size_t begin, size_t end) const;
+
+private:
+    template <typename T>
+    void ProcessRange(const float* pIn, size_t inFrames, T* pOut, size_t begin, size_t end) const;
+    void ComputeTaps(double frac, float* pTaps) const;
+    void InterpolateTaps(uint64_t phase, float* pTaps) const;
+
+    unsigned int m_channels = 2;
+    DecodeQuality m_quality = DecodeQuality::Polyphase;
+
+    // Output frame j sits at input position j * m_step / m_phases (the reduced rate ratio)
+    uint64_t m_phases = 1;
+    uint64_t m_step = 1;
+
+    double m_cutoff = 0.5;  // Cycles per input frame
+    double m_halfWidth = 0; // Window half-width in input frames
+    size_t m_taps = 0;      // Input frames per output frame
+    size_t m_lead = 0;      // Taps before the frame at or left of the position
+
+    // Polyphase: one normalized tap row per table phase. If m_phases fits the table every
+    // row is exact; otherwise rows are spaced evenly and neighbours are interpolated.
+    std::vector<float> m_table;
+    size_t m_tableRows = 0;
+    bool m_exactTable = false;
+};
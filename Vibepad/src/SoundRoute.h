@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Outputs a sound plays on. The values are bit masks: Both = Cable | Monitor.
+enum class SoundRoute : uint8_t {
+    Cable = 1,
+    Monitor = 2,
+    Both = 3
+};
+
+// The mixer keeps one target per route, indexed by this
+inline unsigned int SoundRouteIndex(SoundRoute route) {
+    return (unsigned int)route - 1;
+}
@@ -0,0 +1,18 @@
+#include "StreamResampler.h"
+
+void StreamResampler::Init(unsigned int channels, size_t maxBlockFrames, ResampleQuality quality) {
+    m_channels = channels;
+    m_maxBlockFrames = maxBlockFrames;
+    m_quality = quality;
+    // A chunk needs at most maxBlockFrames * ratio + 4 input frames, with ratio < 2
+    m_fifo.assign((maxBlockFrames * 2 + 6) * channels, 0.0f);
+    Reset();
+}
+
+void StreamResampler::Reset() {
+    // Cubic starts with one silent history frame
+    m_count = m_quality == ResampleQuality::Cubic ? 1 : 0;
+    std::fill(m_fifo.begin(), m_fifo.begin() + (size_t)m_count * m_channels, 0.0f);
+    m_phase = 0.0;
+    m_consumed = 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+enum class ResampleQuality {
+    Linear, // 2 taps
+    Cubic   // 4-tap Catmull-Rom: flatter passband and less phase-dependent dulling, one frame more latency
+};
+
+// Streaming interpolating resampler in pull form: each Process() call
+// produces exactly the requested output frames, pulling as many fresh input
+// frames as the current ratio needs from a render callback. Used to run a bus
+// slightly faster or slower than its device so it stays locked to another clock.
+// At ratio 1 with zero phase the output is exactly the input.
+class StreamResampler {
+public:
+    // Allocates the input FIFO; call before the audio thread uses the resampler
+    void Init(unsigned int channels, size_t maxBlockFrames, ResampleQuality quality = ResampleQuality::Linear);
+    void Reset();
+
+    // Input position (frames consumed + fractional phase) of the next output frame
+    double GetPosition() const { return (double)m_consumed + m_phase; }
+
+    // 'ratio' is input frames per output frame and must stay within (0, 2).
+    // render(float* pDst, unsigned int frames) must add into the zeroed pDst.
+    template <typename RenderFn>
+    void Process(float* pOutput, unsigned int frameCount, double ratio, RenderFn&& render) {
+        while (frameCount > 0) {
+            unsigned int n = (unsigned int)std::min<size_t>(frameCount, m_maxBlockFrames);
+            ProcessChunk(pOutput, n, ratio, render);
+            pOutput += (size_t)n * m_channels;
+            frameCount -= n;
+        }
+    }
+
+private:
+    template <typename RenderFn>
+    void ProcessChunk(float* pOutput, unsigned int n, double ratio, RenderFn& render) {
+        const size_t ch = m_channels;
+        const bool cubic = m_quality == ResampleQuality::Cubic;
+
+        // Input frames [0, needed) cover the interpolation taps of every output frame.
+        // Cubic keeps one frame of history in front, so its positions start at m_fifo[1].
+        // Linear weights the right tap by zero at a whole position, so that frame isn't pulled
+        // yet: at ratio 1 the resampler then needs no input beyond the block it outputs.
+        double last = m_phase + (n - 1) * ratio;
+        size_t needed = (size_t)std::floor(last) + (cubic ? 4 : (last == std::floor(last) ? 1 : 2));
+        if (needed > m_count) {
+            size_t fresh = needed - m_count;
+            float* pFresh = m_fifo.data() + m_count * ch;
+            memset(pFresh, 0, fresh * ch * sizeof(float));
+            render(pFresh, (unsigned int)fresh);
+            m_count = needed;
+        }
+
+        const float* pIn = m_fifo.data();
+        if (cubic) {
+            for (unsigned int j = 0; j < n; ++j) {
+                double pos = m_phase + j * ratio;
+                size_t i = (size_t)pos;
+                float t = (float)(pos - (double)i);
+                const float* p0 = pIn + i * ch;
+                const float* p1 = p0 + ch;
+                const float* p2 = p1 + ch;
+                const float* p3 = p2 + ch;
+                for (size_t c = 0; c < ch; ++c) {
+                    float a = p2[c] - p0[c];
+                    float b = 2.0f * p0[c] - 5.0f * p1[c] + 4.0f * p2[c] - p3[c];
+                    float d = 3.0f * (p1[c] - p2[c]) + p3[c] - p0[c];
+                    pOutput[j * ch + c] = p1[c] + 0.5f * t * (a + t * (b + t * d));
+                }
+            }
+        } else {
+            for (unsigned int j = 0; j < n; ++j) {
+                double pos = m_phase + j * ratio;
+                size_t i = (size_t)pos;
+                float frac = (float)(pos - (double)i);
+                const float* a = pIn + i * ch;
+                const float* b = a + ch;
+                for (size_t c = 0; c < ch; ++c) pOutput[j * ch + c] = a[c] + (b[c] - a[c]) * frac;
+            }
+        }
+
+        double advance = m_phase + n * ratio;
+        size_t drop = (size_t)std::floor(advance);
+        m_phase = advance - (double)drop;
+        m_consumed += drop;
+        m_count -= drop;
+        memmove(m_fifo.data(), m_fifo.data() + drop * ch, m_count * ch * sizeof(float));
+    }
+
+    std::vector<float> m_fifo;
+    size_t m_count = 0;       // Frames buffered in m_fifo
+    double m_phase = 0.0;     // Fractional position within m_fifo[0..1]
+    uint64_t m_consumed = 0;  // Input frames dropped from the FIFO so far
+    unsigned int m_channels = 2;
+    size_t m_maxBlockFrames = 0;
+    ResampleQuality m_quality = ResampleQuality::Linear;
+};
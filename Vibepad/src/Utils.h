@@ -1,14 +1,18 @@
 ﻿#pragma once
 
-#define WIN32_LEAN_AND_MEAN 
-#include <windows.h>
-#include <shellapi.h>       
 #include <string>
 #include <filesystem>
 #include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN 
+#define NOMINMAX
+#include <windows.h>
+#include <shellapi.h>       
 #include <mmsystem.h>
 
 #pragma comment(lib, "winmm.lib")
+#endif
 
 namespace Utils {
 
@@ -16,6 +20,7 @@ namespace Utils {
     // STRING CONVERTERS
     // -----------------------------------------------------------------------------
 
+#ifdef _WIN32
     inline std::string WideToUtf8(const std::wstring& wstr) {
         if (wstr.empty()) return std::string();
         int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
@@ -31,7 +36,49 @@ namespace Utils {
         MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), &wstrTo[0], size_needed);
         return wstrTo;
     }
+#else
+    // Portable fallback so the audio engine builds headless (wchar_t is UTF-32 here)
+    inline std::string WideToUtf8(const std::wstring& wstr) {
+        std::string out;
+        for (wchar_t wc : wstr) {
+            unsigned int cp = (unsigned int)wc;
+            if (cp < 0x80) {
+                out += (char)cp;
+            }
+            else if (cp < 0x800) {
+                out += (char)(0xC0 | (cp >> 6));
+                out += (char)(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000) {
+                out += (char)(0xE0 | (cp >> 12));
+                out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                out += (char)(0x80 | (cp & 0x3F));
+            }
+            else {
+                out += (char)(0xF0 | (cp >> 18));
+                out += (char)(0x80 | ((cp >> 12) & 0x3F));
+                out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                out += (char)(0x80 | (cp & 0x3F));
+            }
+        }
+        return out;
+    }
+
+    inline std::wstring Utf8ToWide(const std::string& str) {
+        std::wstring out;
+        for (size_t i = 0; i < str.size(); ) {
+            unsigned char c = (unsigned char)str[i];
+            int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+            unsigned int cp = (extra == 0) ? c : (c & (0x3F >> extra));
+            for (int k = 1; k <= extra && i + k < str.size(); ++k) cp = (cp << 6) | ((unsigned char)str[i + k] & 0x3F);
+            out += (wchar_t)cp;
+            i += extra + 1;
+        }
+        return out;
+    }
+#endif
 
+#ifdef _WIN32
     // -----------------------------------------------------------------------------
     // DRIVER MANAGEMENT
     // -----------------------------------------------------------------------------
@@ -90,4 +137,5 @@ namespace Utils {
             if (sei.hProcess) CloseHandle(sei.hProcess);
         }
     }
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-capacity slot pool for the voices of one bus. Slots live inline and are
+// never moved, so a voice keeps its slot index for its whole life. Allocate and
+// Free are O(1) (free-list stack + dense list of active slots) and never touch
+// the heap, so the pool is owned and used entirely by one audio thread.
+template <typename T, size_t Capacity>
+class VoicePool {
+    static_assert(Capacity > 0 && Capacity < UINT16_MAX, "Capacity must fit the 16-bit slot indices");
+
+public:
+    VoicePool() {
+        for (size_t i = 0; i < Capacity; ++i) m_freeSlots[i] = (uint16_t)(Capacity - 1 - i);
+    }
+
+    static constexpr size_t GetCapacity() { return Capacity; }
+    size_t Size() const { return m_activeCount; }
+
+    // Returns the new slot's index, or -1 when every slot is in use
+    int Allocate() {
+        if (m_activeCount == Capacity) return -1;
+        uint16_t slot = m_freeSlots[Capacity - 1 - m_activeCount];
+        m_activePos[slot] = (uint16_t)m_activeCount;
+        m_active[m_activeCount++] = slot;
+        return slot;
+    }
+
+    // The slot's contents are left as they are; reset them before or after as needed
+    void Free(int slot) {
+        // Swap the last active entry into the hole
+        uint16_t pos = m_activePos[slot];
+        uint16_t last = m_active[--m_activeCount];
+        m_active[pos] = last;
+        m_activePos[last] = pos;
+        m_freeSlots[Capacity - 1 - m_activeCount] = (uint16_t)slot;
+    }
+
+    // Active slots in no particular order. Free(ActiveSlot(i)) moves the last
+    // active slot to position i, so iterate without advancing after a Free.
+    int ActiveSlot(size_t i) const { return m_active[i]; }
+
+    T& operator[](int slot) { return m_slots[slot]; }
+    const T& operator[](int slot) const { return m_slots[slot]; }
+
+private:
+    T m_slots[Capacity];
+    uint16_t m_active[Capacity];     // Dense list of active slot indices
+    uint16_t m_activePos[Capacity];  // Position of each active slot in m_active
+    uint16_t m_freeSlots[Capacity];  // Stack; the top is at [Capacity - 1 - m_activeCount]
+    size_t m_activeCount = 0;
+};
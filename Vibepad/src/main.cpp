@@ -1,5 +1,6 @@
 ﻿#define _CRT_SECURE_NO_WARNINGS
 #define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 
 #include <windows.h>
 #include <objbase.h> 
@@ -8,6 +9,7 @@
 #include <shellapi.h> 
 #include <string>
 #include <vector>
+#include <set>
 #include <sstream>
 
 #pragma comment(lib, "comctl32.lib")
@@ -26,6 +28,17 @@ HWND hComboMic = NULL;
 HWND hComboCable = NULL;
 HWND hComboMonitor = NULL;
 HWND hBtnSetHotkey = NULL;
+HWND hStatsText = NULL;
+
+struct LoudnessResult {
+    std::wstring filename;
+    double lufs = 0.0;
+};
+
+// Sounds queued for loudness analysis, so none is submitted twice
+std::set<std::wstring> g_loudnessPending;
+// Measurements not yet written to the config; saved once the queue empties
+bool g_loudnessUnsaved = false;
 
 bool g_isRecordingHotkey = false;
 int  g_recordingIndex = -1;
@@ -47,12 +60,17 @@ enum {
     ID_COMBO_MONITOR,
     ID_TRAY_ICON = 2000,
     ID_TRAY_EXIT,
-    ID_TRAY_OPEN
+    ID_TRAY_OPEN,
+    ID_TIMER_STATS = 3000
 };
 
 const UINT WM_TRAY = WM_USER + 1;
+const UINT WM_DECODE_DONE = WM_USER + 2; // wParam: success, lParam: std::wstring* path (owned by receiver)
+const UINT WM_PRELOAD_PROGRESS = WM_USER + 3; // lParam: PreloadProgress* (owned by receiver)
+const UINT WM_LOUDNESS_DONE = WM_USER + 4; // wParam: success, lParam: LoudnessResult* (owned by receiver)
 const int HOTKEY_ID_BASE = 5000;
 const int HOTKEY_ID_PANIC = 4999;
+const UINT STATS_INTERVAL_MS = 1000;
 
 // -----------------------------------------------------------------------------
 // HELPERS
@@ -73,6 +91,17 @@ bool AreDevicesConfigured() {
         !g_config.GetMonitorDeviceId().empty();
 }
 
+PlayParams GetPlayParams(const SoundEntry& sound) {
+    PlayParams params;
+    params.gain = g_config.GetSoundGain(sound);
+    params.pan = sound.pan;
+    params.route = sound.route;
+    // Any stable non-zero id works; the file name is unique within the sounds folder
+    params.tag = std::hash<std::wstring>{}(sound.filename) | 1;
+    params.retrigger = sound.retrigger;
+    return params;
+}
+
 void UnregisterAllHotkeys(HWND hWnd) {
     if (hWnd == NULL) return;
     UnregisterHotKey(hWnd, HOTKEY_ID_PANIC);
@@ -197,6 +226,20 @@ void ApplyDeviceSelection() {
     g_engine.Init(mic, cable, mon);
 }
 
+// Measures every sound without a stored loudness; results are saved to config.json as they arrive
+void StartLoudnessAnalysis() {
+    HWND hWnd = hMainWnd;
+    for (const auto& s : g_config.GetSounds()) {
+        if (s.loudnessKnown || !g_loudnessPending.insert(s.filename).second) continue;
+
+        std::wstring filename = s.filename;
+        g_engine.AnalyzeLoudness(s.GetFullPath(), [hWnd, filename](const std::wstring&, bool success, double lufs) {
+            LoudnessResult* pResult = new LoudnessResult{ filename, lufs };
+            if (!PostMessageW(hWnd, WM_LOUDNESS_DONE, success, (LPARAM)pResult)) delete pResult;
+            });
+    }
+}
+
 void AddSoundDialog() {
     wchar_t szFile[260] = { 0 };
     OPENFILENAMEW ofn;
@@ -215,6 +258,7 @@ void AddSoundDialog() {
         if (g_config.AddSound(fullPath, name)) {
             RefreshSoundList();
             RegisterConfigHotkeys();
+            StartLoudnessAnalysis();
         }
     }
 }
@@ -231,7 +275,7 @@ void PlaySelectedSound() {
         ListView_GetItem(hList, &li);
         const auto& sounds = g_config.GetSounds();
         if ((int)li.lParam < (int)sounds.size())
-            g_engine.PlaySoundFile(sounds[li.lParam].GetFullPath());
+            g_engine.PlaySoundFile(sounds[li.lParam].GetFullPath(), GetPlayParams(sounds[li.lParam]));
     }
 }
 
@@ -281,6 +325,56 @@ void ToggleHotkeyRecording() {
     EnableWindow(hList, FALSE);
 }
 
+void StartPreload() {
+    PreloadMode mode = g_config.GetPreloadMode();
+    if (mode == PreloadMode::Off) return;
+
+    std::vector<std::wstring> paths;
+    for (const auto& s : g_config.GetSounds()) {
+        if (mode == PreloadMode::All || s.hotkey > 0) paths.push_back(s.GetFullPath());
+    }
+
+    HWND hWnd = hMainWnd;
+    g_engine.Preload(paths, (unsigned int)std::max(g_config.GetPreloadThreads(), 0), [hWnd](const PreloadProgress& progress) {
+        PreloadProgress* pProgress = new PreloadProgress(progress);
+        if (!PostMessageW(hWnd, WM_PRELOAD_PROGRESS, 0, (LPARAM)pProgress)) delete pProgress;
+        });
+}
+
+std::wstring FormatCallbackStats(const wchar_t* name, const CallbackStats& c) {
+    wchar_t line[192];
+    swprintf(line, 192, L"%ls: %.2f ms avg / %.2f peak, load %.0f%% / %.0f%%, over budget %llu, late %llu",
+        name, c.avgMs, c.peakMs, c.avgLoad * 100.0, c.peakLoad * 100.0,
+        (unsigned long long)c.overBudget, (unsigned long long)c.lateStarts);
+    return line;
+}
+
+// Called from the stats timer; each call restarts the window that averages and peaks cover
+void UpdateStatsPanel() {
+    EngineStats stats = g_engine.GetEngineStats(true);
+    LatencyReport latency = g_engine.GetLatencyReport();
+
+    wchar_t micLine[192];
+    swprintf(micLine, 192, L"Mic: buffer %.1f ms, drift %+.0f ppm, underruns %llu, overruns %llu",
+        stats.mic.fillMs, stats.mic.driftPpm, (unsigned long long)stats.mic.underruns, (unsigned long long)stats.mic.overruns);
+    wchar_t miscLine[192];
+    swprintf(miscLine, 192, L"Hotkey to audio p99 %.1f ms, dropped cmds %llu, reclaim overflows %llu, monitor underruns %llu",
+        latency.triggerToFirstBlock.p99Ms, (unsigned long long)stats.droppedCommands, (unsigned long long)stats.reclaimOverflows,
+        (unsigned long long)stats.monitorUnderruns);
+
+    wchar_t limiterLine[192];
+    swprintf(limiterLine, 192, L"Limiter: cable -%.1f dB (peak -%.1f), monitor -%.1f dB (peak -%.1f), clipped %llu",
+        stats.cableLimiter.gainReductionDb, stats.cableLimiter.peakReductionDb,
+        stats.monitorLimiter.gainReductionDb, stats.monitorLimiter.peakReductionDb,
+        (unsigned long long)(stats.cableLimiter.clippedSamples + stats.monitorLimiter.clippedSamples));
+
+    std::wstring text = FormatCallbackStats(L"Capture", stats.capture) + L"\n" +
+        FormatCallbackStats(L"Cable", stats.cable) + L"\n" +
+        FormatCallbackStats(L"Monitor", stats.monitor) + L"\n" +
+        micLine + L"\n" + limiterLine + L"\n" + miscLine;
+    SetWindowTextW(hStatsText, text.c_str());
+}
+
 void SetupTrayIcon(HWND hWnd, bool add) {
     NOTIFYICONDATA nid = { 0 };
     nid.cbSize = sizeof(NOTIFYICONDATA);
@@ -386,6 +480,16 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         SendMessage(hSndSlider, TBM_SETRANGE, TRUE, MAKELPARAM(0, 200));
         SendMessage(hSndSlider, TBM_SETPOS, TRUE, (int)(g_config.GetSoundVolume() * 100.0f));
         g_engine.SetSoundVolume(g_config.GetSoundVolume());
+        g_engine.SetStreamThreshold(g_config.GetStreamThreshold());
+        g_engine.SetCacheBudget(g_config.GetCacheBudgetBytes());
+        g_engine.SetDiskCacheEnabled(g_config.GetDiskCacheEnabled());
+        g_engine.SetCompactCache(g_config.GetCompactCache());
+        g_engine.SetDecodeQuality(g_config.GetDecodeQuality());
+        g_engine.SetVoiceLimit((size_t)std::max(g_config.GetMaxVoices(), 1));
+        g_engine.SetVoiceStealPolicy(g_config.GetVoiceStealPolicy());
+        g_engine.SetLimiter(g_config.GetLimiterCeilingDb(), g_config.GetLimiterReleaseMs());
+        g_engine.SetStopFade(g_config.GetStopFadeMs());
+        if (!g_config.GetLatencyLogPath().empty()) g_engine.StartLatencyLog(g_config.GetLatencyLogPath());
 
         HWND grpDev = CreateWindowW(L"BUTTON", L"Audio Devices Configuration", WS_CHILD | WS_VISIBLE | BS_GROUPBOX, 15, 355, 560, 160, hWnd, NULL, NULL, NULL); SetFont(grpDev);
 
@@ -398,6 +502,15 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         lbl = CreateWindowW(L"STATIC", L"Output B (Headphones/Monitor):", WS_CHILD | WS_VISIBLE, 30, 440, 250, 20, hWnd, NULL, NULL, NULL); SetFont(lbl);
         hComboMonitor = CreateWindowW(L"COMBOBOX", L"", WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST, 30, 460, 510, 200, hWnd, (HMENU)ID_COMBO_MONITOR, NULL, NULL); SetFont(hComboMonitor);
 
+        HWND grpStats = CreateWindowW(L"BUTTON", L"Engine Stats", WS_CHILD | WS_VISIBLE | BS_GROUPBOX, 15, 525, 560, 146, hWnd, NULL, NULL, NULL); SetFont(grpStats);
+        hStatsText = CreateWindowW(L"STATIC", L"", WS_CHILD | WS_VISIBLE | SS_LEFT | SS_NOPREFIX, 30, 550, 530, 114, hWnd, NULL, NULL, NULL); SetFont(hStatsText);
+        SetTimer(hWnd, ID_TIMER_STATS, STATS_INTERVAL_MS, NULL);
+
+        g_engine.SetDecodeCallback([hWnd](const std::wstring& path, bool success) {
+            std::wstring* pPath = new std::wstring(path);
+            if (!PostMessageW(hWnd, WM_DECODE_DONE, (WPARAM)success, (LPARAM)pPath)) delete pPath;
+            });
+
         RefreshSoundList();
         PopulateDeviceCombos();
         ApplyDeviceSelection();
@@ -411,7 +524,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         int id = (int)wParam;
 
         if (id == HOTKEY_ID_PANIC) {
-            g_engine.StopAllSounds();
+            g_engine.StopAllSounds(true);
         }
         else {
             if (!AreDevicesConfigured()) {
@@ -422,12 +535,56 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int soundIndex = id - HOTKEY_ID_BASE;
             const auto& sounds = g_config.GetSounds();
             if (soundIndex >= 0 && soundIndex < (int)sounds.size()) {
-                g_engine.PlaySoundFile(sounds[soundIndex].GetFullPath());
+                g_engine.PlaySoundFile(sounds[soundIndex].GetFullPath(), GetPlayParams(sounds[soundIndex]));
             }
         }
     }
     break;
 
+    case WM_DECODE_DONE:
+    {
+        std::wstring* path = (std::wstring*)lParam;
+        if (!wParam) {
+            std::wstring msg = L"Could not decode sound file:\n" + *path;
+            MessageBoxW(hWnd, msg.c_str(), L"Playback Error", MB_ICONWARNING | MB_TOPMOST);
+        }
+        delete path;
+    }
+    break;
+
+    case WM_PRELOAD_PROGRESS:
+    {
+        PreloadProgress* progress = (PreloadProgress*)lParam;
+        if (progress->done < progress->total) {
+            std::wstring title = L"Vibepad - Loading sounds " + std::to_wstring(progress->done) + L"/" + std::to_wstring(progress->total);
+            SetWindowTextW(hWnd, title.c_str());
+        }
+        else {
+            SetWindowTextW(hWnd, L"Vibepad");
+            std::wstring msg = L"Vibepad: preloaded " + std::to_wstring(progress->total - progress->failed) + L"/" +
+                std::to_wstring(progress->total) + L" sounds in " + std::to_wstring((int)progress->elapsedMs) + L" ms\n";
+            OutputDebugStringW(msg.c_str());
+        }
+        delete progress;
+    }
+    break;
+
+    case WM_LOUDNESS_DONE:
+    {
+        LoudnessResult* result = (LoudnessResult*)lParam;
+        g_loudnessPending.erase(result->filename);
+        if (wParam) {
+            g_config.SetSoundLoudness(result->filename, (float)result->lufs);
+            g_loudnessUnsaved = true;
+        }
+        delete result;
+        if (g_loudnessUnsaved && g_loudnessPending.empty()) {
+            g_config.Save();
+            g_loudnessUnsaved = false;
+        }
+    }
+    break;
+
     case WM_COMMAND:
     {
         int id = LOWORD(wParam);
@@ -458,6 +615,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     }
     break;
 
+    case WM_TIMER:
+        // Nobody reads the panel while the window sits in the tray
+        if (wParam == ID_TIMER_STATS && IsWindowVisible(hWnd)) UpdateStatsPanel();
+        break;
+
     case WM_CLOSE:
         ShowWindow(hWnd, SW_HIDE);
         return 0;
@@ -479,6 +641,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
 
     case WM_DESTROY:
+        KillTimer(hWnd, ID_TIMER_STATS);
         DeleteObject(hFontNormal);
         UnregisterAllHotkeys(hWnd);
         SetupTrayIcon(hWnd, false);
@@ -532,13 +695,15 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
 
     hMainWnd = CreateWindowW(L"VibepadClass", L"Vibepad",
         WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX,
-        CW_USEDEFAULT, CW_USEDEFAULT, 610, 580, NULL, NULL, hInstance, NULL);
+        CW_USEDEFAULT, CW_USEDEFAULT, 610, 726, NULL, NULL, hInstance, NULL);
 
     if (!hMainWnd) return FALSE;
     CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
 
     ShowWindow(hMainWnd, nCmdShow);
     UpdateWindow(hMainWnd);
+    StartPreload();
+    StartLoudnessAnalysis();
 
     MSG msg;
     while (GetMessage(&msg, NULL, 0, 0)) {